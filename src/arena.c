@@ -0,0 +1,156 @@
+/* region allocator implementation
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+
+/** default size of a chunk */
+#define ARENA_CHUNK_SIZE (64 * 1024)
+
+/** all allocations are rounded up to this alignment */
+#define ARENA_ALIGN (sizeof(union arena_align))
+
+union arena_align {
+        void *p;
+        long l;
+        double d;
+};
+
+struct arena_chunk {
+        struct arena_chunk *next;
+        size_t size; /**< usable bytes in chunk */
+        size_t used; /**< bytes already handed out */
+        union arena_align data[];
+};
+
+struct arena {
+        struct arena_chunk *chunks; /**< current chunk at head of list */
+};
+
+static struct arena_chunk *arena_chunk_new(size_t size)
+{
+        struct arena_chunk *chunk;
+
+        chunk = malloc(sizeof(struct arena_chunk) + size);
+        if (chunk == NULL) {
+                return NULL;
+        }
+        chunk->next = NULL;
+        chunk->size = size;
+        chunk->used = 0;
+
+        return chunk;
+}
+
+/* exported interface documented in arena.h */
+struct arena *arena_new(void)
+{
+        return calloc(1, sizeof(struct arena));
+}
+
+/* exported interface documented in arena.h */
+void arena_free(struct arena *arena)
+{
+        struct arena_chunk *chunk;
+        struct arena_chunk *next;
+
+        if (arena == NULL) {
+                return;
+        }
+
+        for (chunk = arena->chunks; chunk != NULL; chunk = next) {
+                next = chunk->next;
+                free(chunk);
+        }
+        free(arena);
+}
+
+/* exported interface documented in arena.h */
+void *arena_alloc(struct arena *arena, size_t size)
+{
+        struct arena_chunk *chunk;
+        void *res;
+
+        size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+        chunk = arena->chunks;
+        if ((chunk == NULL) || ((chunk->size - chunk->used) < size)) {
+                if (size > (ARENA_CHUNK_SIZE / 4)) {
+                        /* large allocations get a chunk of their own
+                         * placed behind the current one so its free
+                         * space is not wasted
+                         */
+                        chunk = arena_chunk_new(size);
+                        if (chunk == NULL) {
+                                return NULL;
+                        }
+                        if (arena->chunks == NULL) {
+                                arena->chunks = chunk;
+                        } else {
+                                chunk->next = arena->chunks->next;
+                                arena->chunks->next = chunk;
+                        }
+                } else {
+                        chunk = arena_chunk_new(ARENA_CHUNK_SIZE);
+                        if (chunk == NULL) {
+                                return NULL;
+                        }
+                        chunk->next = arena->chunks;
+                        arena->chunks = chunk;
+                }
+        }
+
+        res = (char *)chunk->data + chunk->used;
+        chunk->used += size;
+        memset(res, 0, size);
+
+        return res;
+}
+
+/* exported interface documented in arena.h */
+char *arena_strndup(struct arena *arena, const char *s, size_t n)
+{
+        size_t len = 0;
+        char *res;
+
+        while ((len < n) && (s[len] != 0)) {
+                len++;
+        }
+
+        res = arena_alloc(arena, len + 1);
+        if (res != NULL) {
+                memcpy(res, s, len);
+                res[len] = 0;
+        }
+        return res;
+}
+
+/* exported interface documented in arena.h */
+char *arena_strdup(struct arena *arena, const char *s)
+{
+        return arena_strndup(arena, s, strlen(s));
+}
+
+/* exported interface documented in arena.h */
+size_t arena_usage(struct arena *arena, size_t *used)
+{
+        struct arena_chunk *chunk;
+        size_t size = 0;
+
+        *used = 0;
+        if (arena == NULL) {
+                return 0;
+        }
+
+        for (chunk = arena->chunks; chunk != NULL; chunk = chunk->next) {
+                size += sizeof(struct arena_chunk) + chunk->size;
+                *used += chunk->used;
+        }
+        return size;
+}
@@ -0,0 +1,58 @@
+/* region allocator
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ */
+
+#ifndef nsgenbind_arena_h
+#define nsgenbind_arena_h
+
+#include <stddef.h>
+
+struct arena;
+
+/**
+ * create a new arena
+ *
+ * Allocations are carved sequentially from large chunks and are only
+ * released all together by arena_free()
+ *
+ * \return new arena or NULL on memory exhaustion
+ */
+struct arena *arena_new(void);
+
+/**
+ * release an arena and every allocation made from it
+ */
+void arena_free(struct arena *arena);
+
+/**
+ * allocate zeroed memory from an arena
+ *
+ * \param arena The arena to allocate from.
+ * \param size The number of bytes to allocate.
+ * \return pointer to suitably aligned memory or NULL on memory exhaustion
+ */
+void *arena_alloc(struct arena *arena, size_t size);
+
+/**
+ * duplicate at most n characters of a string into an arena
+ */
+char *arena_strndup(struct arena *arena, const char *s, size_t n);
+
+/**
+ * duplicate a string into an arena
+ */
+char *arena_strdup(struct arena *arena, const char *s);
+
+/**
+ * get the memory held by an arena
+ *
+ * \param arena The arena to measure, may be NULL.
+ * \param used Updated with the bytes handed out by allocations.
+ * \return the bytes allocated for chunks
+ */
+size_t arena_usage(struct arena *arena, size_t *used);
+
+#endif
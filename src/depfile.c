@@ -0,0 +1,147 @@
+/* make dependency file generation implementation
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include "options.h"
+#include "arena.h"
+#include "hashtable.h"
+#include "depfile.h"
+
+struct depfile_entry {
+        struct depfile_entry *next;
+        const char *filename;
+};
+
+/**
+ * arena holding the recorded filenames
+ */
+static struct arena *depfile_arena;
+
+/**
+ * recorded filenames used to avoid duplicates
+ */
+static struct hashtable *depfile_table;
+
+/**
+ * recorded inputs in the order they were read
+ */
+static struct depfile_entry *depfile_entries;
+static struct depfile_entry **depfile_tail = &depfile_entries;
+
+/* exported interface documented in depfile.h */
+void depfile_add(const char *filename)
+{
+        struct depfile_entry *entry;
+
+        if (options->depfilename == NULL) {
+                /* no dependency file requested */
+                return;
+        }
+
+        if (depfile_table == NULL) {
+                depfile_arena = arena_new();
+                depfile_table = hashtable_new();
+                if ((depfile_arena == NULL) || (depfile_table == NULL)) {
+                        fprintf(stderr, "Error: out of memory\n");
+                        exit(EXIT_FAILURE);
+                }
+        }
+
+        if (hashtable_find(depfile_table, filename) != NULL) {
+                return;
+        }
+
+        entry = arena_alloc(depfile_arena, sizeof(struct depfile_entry));
+        if (entry != NULL) {
+                entry->filename = arena_strdup(depfile_arena, filename);
+        }
+        if ((entry == NULL) ||
+            (entry->filename == NULL) ||
+            (hashtable_insert(depfile_table, entry->filename, entry) != 0)) {
+                fprintf(stderr, "Error: out of memory\n");
+                exit(EXIT_FAILURE);
+        }
+
+        *depfile_tail = entry;
+        depfile_tail = &entry->next;
+}
+
+/**
+ * write a filename escaping characters special to make
+ */
+static void depfile_write_name(FILE *depf, const char *filename)
+{
+        for (; *filename != 0; filename++) {
+                switch (*filename) {
+                case ' ':
+                case '#':
+                        fputc('\\', depf);
+                        break;
+
+                case '$':
+                        fputc('$', depf);
+                        break;
+
+                default:
+                        break;
+                }
+                fputc(*filename, depf);
+        }
+}
+
+/* exported interface documented in depfile.h */
+int depfile_write(const char *depfilename)
+{
+        struct depfile_entry *entry;
+        FILE *depf;
+
+        depf = fopen(depfilename, "w");
+        if (depf == NULL) {
+                fprintf(stderr, "Error: unable to open file %s (%s)\n",
+                        depfilename, strerror(errno));
+                return -1;
+        }
+
+        depfile_write_name(depf, depfilename);
+        fputc(':', depf);
+        for (entry = depfile_entries; entry != NULL; entry = entry->next) {
+                fputs(" \\\n\t", depf);
+                depfile_write_name(depf, entry->filename);
+        }
+        fputc('\n', depf);
+
+        /* empty rules so removed inputs do not break the build */
+        for (entry = depfile_entries; entry != NULL; entry = entry->next) {
+                fputc('\n', depf);
+                depfile_write_name(depf, entry->filename);
+                fputs(":\n", depf);
+        }
+
+        if (fclose(depf) != 0) {
+                fprintf(stderr, "Error: unable to write file %s (%s)\n",
+                        depfilename, strerror(errno));
+                return -1;
+        }
+
+        return 0;
+}
+
+/* exported interface documented in depfile.h */
+void depfile_free(void)
+{
+        hashtable_free(depfile_table);
+        arena_free(depfile_arena);
+        depfile_table = NULL;
+        depfile_arena = NULL;
+        depfile_entries = NULL;
+        depfile_tail = &depfile_entries;
+}
@@ -0,0 +1,38 @@
+/* make dependency file generation
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ */
+
+#ifndef nsgenbind_depfile_h
+#define nsgenbind_depfile_h
+
+/**
+ * record an input file the tool has read
+ *
+ * Each file is only recorded once no matter how often it is added.
+ * Nothing is recorded unless a dependency file was requested.
+ *
+ * \param filename The path the file was opened with.
+ */
+void depfile_add(const char *filename);
+
+/**
+ * write a make compatible dependency file
+ *
+ * The file names the dependency file itself as the target depending on
+ * every input recorded with depfile_add(). An empty rule is also written
+ * for each input so make does not fail if one is removed.
+ *
+ * \param depfilename The path of the dependency file to write.
+ * \return 0 on success else -1
+ */
+int depfile_write(const char *depfilename);
+
+/**
+ * release the recorded inputs
+ */
+void depfile_free(void);
+
+#endif
@@ -34,7 +34,7 @@
 /* exported interface documented in duk-libdom.h */
 int output_tool_preface(struct opctx *outc)
 {
-        outputf(outc, "%s", NSGENBIND_PREFACE);
+        outputs(outc, NSGENBIND_PREFACE);
 
         return 0;
 }
@@ -52,7 +52,7 @@ int output_cdata(struct opctx *outc,
                         genbind_node_getnode(node),
                         NULL, nodetype));
         if (cdata != NULL) {
-                outputf(outc, "%s", cdata);
+                outputs(outc, cdata);
                 res = 1;
         }
         return res;
@@ -76,7 +76,12 @@ int output_ccode(struct opctx *outc, struct genbind_node *node)
                         NULL, GENBIND_NODE_TYPE_FILE));
 
         if ((line != NULL) && (filename != NULL)) {
+                filename = genb_mappath(filename);
+                if (filename == NULL) {
+                        return -1;
+                }
                 outputf(outc, "#line %d \"%s\"\n", (*line) + 1, filename);
+                free(filename);
                 res = output_cdata(outc, node, GENBIND_NODE_TYPE_CDATA);
                 output_line(outc);
         } else {
@@ -87,21 +92,60 @@ int output_ccode(struct opctx *outc, struct genbind_node *node)
 }
 
 /* exported interface documented in duk-libdom.h */
-int output_tool_prologue(struct opctx *outc)
+int output_tool_include(struct opctx *outc, const char *fname)
 {
         char *fpath;
 
-        fpath = genb_fpath("binding.h");
-        outputf(outc, "\n#include \"%s\"\n", fpath);
-        free(fpath);
+        /* the generated headers are beside the generated sources so
+         * they may be found relative to the including file
+         */
+        if (options->reproducible) {
+                outputf(outc, "#include \"%s\"\n", fname);
+                return 0;
+        }
 
-        fpath = genb_fpath("private.h");
+        fpath = genb_fpath(fname);
         outputf(outc, "#include \"%s\"\n", fpath);
         free(fpath);
 
-        fpath = genb_fpath("prototype.h");
-        outputf(outc, "#include \"%s\"\n", fpath);
-        free(fpath);
+        return 0;
+}
+
+/* exported interface documented in duk-libdom.h */
+int output_tool_prologue(struct opctx *outc)
+{
+        outputc(outc, '\n');
+
+        output_tool_include(outc, "binding.h");
+
+        /* each class includes its own headers instead */
+        if (!options->classheaders) {
+                output_tool_include(outc, "private.h");
+                output_tool_include(outc, "prototype.h");
+        }
+
+        return 0;
+}
+
+/* exported interface documented in duk-libdom.h */
+int output_tool_class_include(struct opctx *outc, struct ir_entry *entry)
+{
+        char *fname;
+        int fnamel;
+
+        if (!options->classheaders) {
+                return 0;
+        }
+
+        fnamel = strlen(entry->class_name) + SLEN("_prototype.h") + 1;
+        fname = malloc(fnamel);
+        if (fname == NULL) {
+                return -1;
+        }
+        snprintf(fname, fnamel, "%s_prototype.h", entry->class_name);
+
+        output_tool_include(outc, fname);
+        free(fname);
 
         return 0;
 }
@@ -119,7 +163,7 @@ int output_ctype(struct opctx *outc, struct genbind_node *node, bool identifier)
         while (typename_node != NULL) {
                 type_cdata = genbind_node_gettext(typename_node);
 
-                outputf(outc, "%s", type_cdata);
+                outputs(outc, type_cdata);
 
                 typename_node = genbind_node_find_type(
                         genbind_node_getnode(node),
@@ -38,26 +38,9 @@ get_member_default_str(struct ir_entry *dictionarye,
                        enum webidl_type member_type,
                        char **defl_out)
 {
-        struct webidl_node *lit_node;
-        enum webidl_node_type lit_type;
-        int *lit_int;
-        float *lit_flt;
-
-        lit_node = webidl_node_getnode(
-                webidl_node_find_type(
-                        webidl_node_getnode(membere->node),
-                        NULL,
-                        WEBIDL_NODE_TYPE_OPTIONAL));
-        if (lit_node == NULL) {
-                *defl_out = NULL;
-                return 0;
-        }
-
-        lit_type = webidl_node_gettype(lit_node);
-
-        switch (lit_type) {
+        switch (membere->defl.type) {
 
-        case WEBIDL_NODE_TYPE_LITERAL_BOOL:
+        case IR_LITERAL_BOOL:
                 if (member_type != WEBIDL_TYPE_BOOL) {
                         fprintf(stderr,
                                 "Dictionary %s:%s literal boolean type mismatch\n",
@@ -65,32 +48,29 @@ get_member_default_str(struct ir_entry *dictionarye,
                                 membere->name);
                         return -1;
                 }
-                lit_int = webidl_node_getint(lit_node);
-                if (*lit_int == 0) {
+                if (membere->defl.number == 0) {
                         *defl_out = strdup("false");
                 } else {
                         *defl_out = strdup("true");
                 }
                 break;
 
-        case WEBIDL_NODE_TYPE_LITERAL_NULL:
+        case IR_LITERAL_NULL:
                 *defl_out = strdup("NULL");
                 break;
 
-        case WEBIDL_NODE_TYPE_LITERAL_STRING:
-                *defl_out = strdup(webidl_node_gettext(lit_node));
+        case IR_LITERAL_STRING:
+                *defl_out = strdup(membere->defl.text);
                 break;
 
-        case WEBIDL_NODE_TYPE_LITERAL_INT:
-                lit_int = webidl_node_getint(lit_node);
+        case IR_LITERAL_INT:
                 *defl_out = malloc(128);
-                snprintf(*defl_out, 128, "%d", *lit_int);
+                snprintf(*defl_out, 128, "%d", membere->defl.number);
                 break;
 
-        case WEBIDL_NODE_TYPE_LITERAL_FLOAT:
-                lit_flt = webidl_node_getfloat(lit_node);
+        case IR_LITERAL_FLOAT:
                 *defl_out = malloc(128);
-                snprintf(*defl_out, 128, "%f", *lit_flt);
+                snprintf(*defl_out, 128, "%f", membere->defl.flt);
                 break;
 
         default:
@@ -110,30 +90,18 @@ output_member_acessor(struct opctx *outc,
                       struct ir_entry *dictionarye,
                       struct ir_operation_argument_entry *membere)
 {
-        struct webidl_node *type_node;
-        enum webidl_type *argument_type;
+        enum webidl_type argument_type;
         char *defl; /* default for member */
         int res;
 
-        type_node = webidl_node_find_type(
-                webidl_node_getnode(membere->node),
-                NULL,
-                WEBIDL_NODE_TYPE_TYPE);
-
-        if (type_node == NULL) {
+        if (membere->typec == 0) {
                 fprintf(stderr, "%s:%s has no type\n",
                         dictionarye->name,
                         membere->name);
                 return -1;
         }
 
-        argument_type = (enum webidl_type *)webidl_node_getint(
-                webidl_node_find_type(
-                        webidl_node_getnode(type_node),
-                        NULL,
-                        WEBIDL_NODE_TYPE_TYPE_BASE));
-
-        if (argument_type == NULL) {
+        if (membere->typev[0].nobase) {
                 fprintf(stderr,
                         "%s:%s has no type base\n",
                         dictionarye->name,
@@ -141,13 +109,15 @@ output_member_acessor(struct opctx *outc,
                 return -1;
         }
 
+        argument_type = membere->typev[0].base;
+
         /* get default text */
-        res = get_member_default_str(dictionarye, membere, *argument_type, &defl);
+        res = get_member_default_str(dictionarye, membere, argument_type, &defl);
         if (res != 0) {
                 return res;
         }
 
-        switch (*argument_type) {
+        switch (argument_type) {
 
         case WEBIDL_TYPE_STRING:
                 outputf(outc,
@@ -157,7 +127,7 @@ output_member_acessor(struct opctx *outc,
                         DLPFX, dictionarye->class_name, membere->name);
 
                 if (defl == NULL) {
-                        outputf(outc,
+                        outputs(outc,
                                 "\tconst char *ret = NULL; /* No default */\n");
                 } else {
                         outputf(outc,
@@ -188,7 +158,7 @@ output_member_acessor(struct opctx *outc,
                         DLPFX, dictionarye->class_name, membere->name);
 
                 if (defl == NULL) {
-                        outputf(outc,
+                        outputs(outc,
                                 "\tduk_bool_t ret = false; /* No default */\n");
                 } else {
                 outputf(outc,
@@ -221,7 +191,7 @@ output_member_acessor(struct opctx *outc,
                         DLPFX, dictionarye->class_name, membere->name);
 
                 if (defl == NULL) {
-                        outputf(outc,
+                        outputs(outc,
                                 "\tduk_int_t ret = 0; /* No default */\n");
                 } else {
                         outputf(outc,
@@ -257,7 +227,7 @@ output_member_acessor(struct opctx *outc,
                         "\tduk_get_prop_string(ctx, idx, \"%s\");\n",
                         defl, membere->name, membere->name);
 
-                outputf(outc,
+                outputs(outc,
                         "\t/* ... obj@idx ... value/undefined */\n"
                         "\tif (!duk_is_undefined(ctx, -1)) {\n"
                         "\t\t/* Note, this throws a duk_error if it's not a number */\n"
@@ -273,12 +243,12 @@ output_member_acessor(struct opctx *outc,
                         "Dictionary %s:%s unhandled type (%d)",
                         dictionarye->name,
                         membere->name,
-                        *argument_type);
+                        argument_type);
                 outputf(outc,
                         "/* Dictionary %s:%s unhandled type (%d) */\n\n",
                         dictionarye->name,
                         membere->name,
-                        *argument_type);
+                        argument_type);
         }
 
         if (defl != NULL) {
@@ -311,73 +281,95 @@ output_member_acessors(struct opctx *outc, struct ir_entry *dictionarye)
 
 
 /* exported function documented in duk-libdom.h */
-int output_dictionary(struct ir *ir, struct ir_entry *dictionarye)
+int
+output_dictionary_section(struct opctx *dyop,
+                          struct ir *ir,
+                          struct ir_entry *dictionarye,
+                          bool standalone)
 {
-        struct opctx *dyop;
-        int res = 0;
-
-        /* open the output */
-        res = output_open(dictionarye->filename, &dyop);
-        if (res != 0) {
-                return res;
-        }
+        int res;
 
-        /* tool preface */
-        output_tool_preface(dyop);
+        if (standalone) {
+                /* tool preface */
+                output_tool_preface(dyop);
 
-        /* binding preface */
-        output_method_cdata(dyop,
-                            ir->binding_node,
-                            GENBIND_METHOD_TYPE_PREFACE);
+                /* binding preface */
+                output_method_cdata(dyop,
+                                    ir->binding_node,
+                                    GENBIND_METHOD_TYPE_PREFACE);
+        }
 
         /* class preface */
         output_method_cdata(dyop,
                             dictionarye->class,
                             GENBIND_METHOD_TYPE_PREFACE);
 
-        /* tool prologue */
-        output_tool_prologue(dyop);
+        if (standalone) {
+                /* tool prologue */
+                output_tool_prologue(dyop);
+                output_tool_class_include(dyop, dictionarye);
 
-        /* binding prologue */
-        output_method_cdata(dyop,
-                            ir->binding_node,
-                            GENBIND_METHOD_TYPE_PROLOGUE);
+                /* binding prologue */
+                output_method_cdata(dyop,
+                                    ir->binding_node,
+                                    GENBIND_METHOD_TYPE_PROLOGUE);
+        }
 
         /* class prologue */
         output_method_cdata(dyop,
                             dictionarye->class,
                             GENBIND_METHOD_TYPE_PROLOGUE);
 
-        outputf(dyop, "\n");
+        outputs(dyop, "\n");
 
         res = output_member_acessors(dyop, dictionarye);
         if (res != 0) {
-                goto op_error;
+                return res;
         }
 
-        outputf(dyop, "\n");
+        outputs(dyop, "\n");
 
         /* class epilogue */
         output_method_cdata(dyop,
                             dictionarye->class,
                             GENBIND_METHOD_TYPE_EPILOGUE);
 
-        /* binding epilogue */
-        output_method_cdata(dyop,
-                            ir->binding_node,
-                            GENBIND_METHOD_TYPE_EPILOGUE);
+        if (standalone) {
+                /* binding epilogue */
+                output_method_cdata(dyop,
+                                    ir->binding_node,
+                                    GENBIND_METHOD_TYPE_EPILOGUE);
+        }
 
         /* class postface */
         output_method_cdata(dyop,
                             dictionarye->class,
                             GENBIND_METHOD_TYPE_POSTFACE);
 
-        /* binding postface */
-        output_method_cdata(dyop,
-                            ir->binding_node,
-                            GENBIND_METHOD_TYPE_POSTFACE);
+        if (standalone) {
+                /* binding postface */
+                output_method_cdata(dyop,
+                                    ir->binding_node,
+                                    GENBIND_METHOD_TYPE_POSTFACE);
+        }
+
+        return 0;
+}
+
+/* exported function documented in duk-libdom.h */
+int output_dictionary(struct ir *ir, struct ir_entry *dictionarye)
+{
+        struct opctx *dyop;
+        int res = 0;
+
+        /* open the output */
+        res = output_open(dictionarye->filename, &dyop);
+        if (res != 0) {
+                return res;
+        }
+
+        res = output_dictionary_section(dyop, ir, dictionarye, true);
 
-op_error:
         output_close(dyop);
 
         return res;
@@ -391,28 +383,16 @@ output_member_declaration(struct opctx *outc,
                           struct ir_entry *dictionarye,
                           struct ir_operation_argument_entry *membere)
 {
-        struct webidl_node *type_node;
-        enum webidl_type *argument_type;
+        enum webidl_type argument_type;
 
-        type_node = webidl_node_find_type(
-                webidl_node_getnode(membere->node),
-                NULL,
-                WEBIDL_NODE_TYPE_TYPE);
-
-        if (type_node == NULL) {
+        if (membere->typec == 0) {
                 fprintf(stderr, "%s:%s has no type\n",
                         dictionarye->name,
                         membere->name);
                 return -1;
         }
 
-        argument_type = (enum webidl_type *)webidl_node_getint(
-                webidl_node_find_type(
-                        webidl_node_getnode(type_node),
-                        NULL,
-                        WEBIDL_NODE_TYPE_TYPE_BASE));
-
-        if (argument_type == NULL) {
+        if (membere->typev[0].nobase) {
                 fprintf(stderr,
                         "%s:%s has no type base\n",
                         dictionarye->name,
@@ -420,8 +400,10 @@ output_member_declaration(struct opctx *outc,
                 return -1;
         }
 
+        argument_type = membere->typev[0].base;
+
 
-        switch (*argument_type) {
+        switch (argument_type) {
 
         case WEBIDL_TYPE_STRING:
                 outputf(outc,
@@ -455,7 +437,7 @@ output_member_declaration(struct opctx *outc,
                         "/* Dictionary %s:%s unhandled type (%d) */\n",
                         dictionarye->name,
                         membere->name,
-                        *argument_type);
+                        argument_type);
         }
 
         return 0;
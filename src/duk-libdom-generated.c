@@ -48,10 +48,10 @@ output_generated_attribute_user_getter(struct opctx *outc,
                 }
 
                 if (interfacee->u.interface.primary_global) {
-                        outputf(outc,
+                        outputs(outc,
                                 "\tdom_event_target *et = NULL;\n");
                 } else {
-                        outputf(outc,
+                        outputs(outc,
                                 "\tdom_event_target *et = (dom_event_target *)(((node_private_t *)priv)->node);\n");
                 }
                 outputf(outc,
@@ -92,7 +92,7 @@ output_generated_attribute_getter(struct opctx *outc,
 
         switch (atributee->typev[0].base) {
         case WEBIDL_TYPE_STRING:
-                outputf(outc,
+                outputs(outc,
                         "\tdom_exception exc;\n"
                         "\tdom_string *str;\n"
                         "\n");
@@ -101,7 +101,7 @@ output_generated_attribute_getter(struct opctx *outc,
                         interfacee->class_name,
                         atributee->property_name,
                         interfacee->class_name);
-                outputf(outc,
+                outputs(outc,
                         "\tif (exc != DOM_NO_ERR) {\n"
                         "\t\treturn 0;\n"
                         "\t}\n"
@@ -113,13 +113,13 @@ output_generated_attribute_getter(struct opctx *outc,
                         "\t\tdom_string_unref(str);\n"
                         "\t} else {\n");
                 if (atributee->typev[0].nullable) {
-                        outputf(outc,
+                        outputs(outc,
                                 "\t\tduk_push_null(ctx);\n");
                 } else {
-                        outputf(outc,
+                        outputs(outc,
                                 "\t\tduk_push_lstring(ctx, NULL, 0);\n");
                 }
-                outputf(outc,
+                outputs(outc,
                         "\t}\n"
                         "\n"
                         "\treturn 1;\n");
@@ -127,13 +127,13 @@ output_generated_attribute_getter(struct opctx *outc,
 
         case WEBIDL_TYPE_LONG:
                 if (atributee->typev[0].modifier == WEBIDL_TYPE_MODIFIER_UNSIGNED) {
-                        outputf(outc,
+                        outputs(outc,
                                 "\tdom_ulong l;\n");
                 } else {
-                        outputf(outc,
+                        outputs(outc,
                                 "\tdom_long l;\n");
                 }
-                outputf(outc,
+                outputs(outc,
                         "\tdom_exception exc;\n"
                         "\n");
                 outputf(outc,
@@ -141,7 +141,7 @@ output_generated_attribute_getter(struct opctx *outc,
                         interfacee->class_name,
                         atributee->property_name,
                         interfacee->class_name);
-                outputf(outc,
+                outputs(outc,
                         "\tif (exc != DOM_NO_ERR) {\n"
                         "\t\treturn 0;\n"
                         "\t}\n"
@@ -153,13 +153,13 @@ output_generated_attribute_getter(struct opctx *outc,
 
         case WEBIDL_TYPE_SHORT:
                 if (atributee->typev[0].modifier == WEBIDL_TYPE_MODIFIER_UNSIGNED) {
-                        outputf(outc,
+                        outputs(outc,
                                 "\tdom_ushort s;\n");
                 } else {
-                        outputf(outc,
+                        outputs(outc,
                                 "\tdom_short s;\n");
                 }
-                outputf(outc,
+                outputs(outc,
                         "\tdom_exception exc;\n"
                         "\n");
                 outputf(outc,
@@ -167,7 +167,7 @@ output_generated_attribute_getter(struct opctx *outc,
                         interfacee->class_name,
                         atributee->property_name,
                         interfacee->class_name);
-                outputf(outc,
+                outputs(outc,
                         "\tif (exc != DOM_NO_ERR) {\n"
                         "\t\treturn 0;\n"
                         "\t}\n"
@@ -178,7 +178,7 @@ output_generated_attribute_getter(struct opctx *outc,
                 break;
 
         case WEBIDL_TYPE_BOOL:
-                outputf(outc,
+                outputs(outc,
                         "\tdom_exception exc;\n"
                         "\tbool b;\n"
                         "\n");
@@ -187,7 +187,7 @@ output_generated_attribute_getter(struct opctx *outc,
                         interfacee->class_name,
                         atributee->property_name,
                         interfacee->class_name);
-                outputf(outc,
+                outputs(outc,
                         "\tif (exc != DOM_NO_ERR) {\n"
                         "\t\treturn 0;\n"
                         "\t}\n"
@@ -237,10 +237,10 @@ output_generated_attribute_user_setter(struct opctx *outc,
                 }
 
                 if (interfacee->u.interface.primary_global) {
-                        outputf(outc,
+                        outputs(outc,
                                 "\tdom_element *et = NULL;\n");
                 } else {
-                        outputf(outc,
+                        outputs(outc,
                                 "\tdom_element *et = (dom_element *)(((node_private_t *)priv)->node);\n");
                 }
 
@@ -285,14 +285,14 @@ output_generated_attribute_setter(struct opctx *outc,
 
         switch (atributee->typev[0].base) {
         case WEBIDL_TYPE_STRING:
-                outputf(outc,
+                outputs(outc,
                         "\tdom_exception exc;\n"
                         "\tdom_string *str;\n"
                         "\tduk_size_t slen;\n"
                         "\tconst char *s;\n");
                 if ((atributee->treatnullas != NULL) &&
                     (strcmp(atributee->treatnullas, "EmptyString") == 0)) {
-                        outputf(outc,
+                        outputs(outc,
                                 "\tif (duk_is_null(ctx, 0)) {\n"
                                 "\t\ts = \"\";\n"
                                 "\t\tslen = 0;\n"
@@ -300,10 +300,10 @@ output_generated_attribute_setter(struct opctx *outc,
                                 "\t\ts = duk_safe_to_lstring(ctx, 0, &slen);\n"
                                 "\t}\n");
                 } else {
-                        outputf(outc,
+                        outputs(outc,
                                 "\ts = duk_safe_to_lstring(ctx, 0, &slen);\n");
                 }
-                outputf(outc,
+                outputs(outc,
                         "\n"
                         "\texc = dom_string_create((const uint8_t *)s, slen, &str);\n"
                         "\tif (exc != DOM_NO_ERR) {\n"
@@ -315,7 +315,7 @@ output_generated_attribute_setter(struct opctx *outc,
                         interfacee->class_name,
                         atributee->property_name,
                         interfacee->class_name);
-                outputf(outc,
+                outputs(outc,
                         "\tdom_string_unref(str);\n"
                         "\tif (exc != DOM_NO_ERR) {\n"
                         "\t\treturn 0;\n"
@@ -326,14 +326,14 @@ output_generated_attribute_setter(struct opctx *outc,
 
         case WEBIDL_TYPE_LONG:
                 if (atributee->typev[0].modifier == WEBIDL_TYPE_MODIFIER_UNSIGNED) {
-                        outputf(outc,
+                        outputs(outc,
                                 "\tdom_exception exc;\n"
                                 "\tdom_ulong l;\n"
                                 "\n"
                                 "\tl = duk_get_uint(ctx, 0);\n"
                                 "\n");
                 } else {
-                        outputf(outc,
+                        outputs(outc,
                                 "\tdom_exception exc;\n"
                                 "\tdom_long l;\n"
                                 "\n"
@@ -345,7 +345,7 @@ output_generated_attribute_setter(struct opctx *outc,
                         interfacee->class_name,
                         atributee->property_name,
                         interfacee->class_name);
-                outputf(outc,
+                outputs(outc,
                         "\tif (exc != DOM_NO_ERR) {\n"
                         "\t\treturn 0;\n"
                         "\t}\n"
@@ -355,14 +355,14 @@ output_generated_attribute_setter(struct opctx *outc,
 
         case WEBIDL_TYPE_SHORT:
                 if (atributee->typev[0].modifier == WEBIDL_TYPE_MODIFIER_UNSIGNED) {
-                        outputf(outc,
+                        outputs(outc,
                                 "\tdom_exception exc;\n"
                                 "\tdom_ushort s;\n"
                                 "\n"
                                 "\ts = duk_get_uint(ctx, 0);\n"
                                 "\n");
                 } else {
-                        outputf(outc,
+                        outputs(outc,
                                 "\tdom_exception exc;\n"
                                 "\tdom_short s;\n"
                                 "\n"
@@ -374,7 +374,7 @@ output_generated_attribute_setter(struct opctx *outc,
                         interfacee->class_name,
                         atributee->property_name,
                         interfacee->class_name);
-                outputf(outc,
+                outputs(outc,
                         "\tif (exc != DOM_NO_ERR) {\n"
                         "\t\treturn 0;\n"
                         "\t}\n"
@@ -383,7 +383,7 @@ output_generated_attribute_setter(struct opctx *outc,
                 break;
 
         case WEBIDL_TYPE_BOOL:
-                outputf(outc,
+                outputs(outc,
                         "\tdom_exception exc;\n"
                         "\tbool b;\n"
                         "\n"
@@ -394,7 +394,7 @@ output_generated_attribute_setter(struct opctx *outc,
                         interfacee->class_name,
                         atributee->property_name,
                         interfacee->class_name);
-                outputf(outc,
+                outputs(outc,
                         "\tif (exc != DOM_NO_ERR) {\n"
                         "\t\treturn 0;\n"
                         "\t}\n"
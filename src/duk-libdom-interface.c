@@ -98,14 +98,14 @@ static bool compare_ctypes(struct genbind_node *a, struct genbind_node *b)
 static int
 output_create_private(struct opctx *outc, char *class_name)
 {
-        outputf(outc,
+        outputs(outc,
                 "\t/* create private data and attach to instance */\n");
         outputf(outc,
                 "\t%s_private_t *priv = calloc(1, sizeof(*priv));\n",
                 class_name);
-        outputf(outc,
+        outputs(outc,
                 "\tif (priv == NULL) return 0;\n");
-        outputf(outc,
+        outputs(outc,
                 "\tduk_push_pointer(ctx, priv);\n");
         outputf(outc,
                 "\tduk_put_prop_string(ctx, 0, %s_magic_string_private);\n\n",
@@ -126,11 +126,11 @@ output_safe_get_private(struct opctx *outc, char *class_name, int idx)
         outputf(outc,
                 "\tduk_get_prop_string(ctx, %d, %s_magic_string_private);\n",
                 idx, DLPFX);
-        outputf(outc,
+        outputs(outc,
                 "\tpriv = duk_get_pointer(ctx, -1);\n");
-        outputf(outc,
+        outputs(outc,
                 "\tduk_pop(ctx);\n");
-        outputf(outc,
+        outputs(outc,
                 "\tif (priv == NULL) return 0;\n\n");
 
         return 0;
@@ -146,7 +146,7 @@ static int output_get_prototype(struct opctx *outc, const char *interface_name)
 
         proto_name = get_prototype_name(interface_name);
 
-        outputf(outc,
+        outputs(outc,
                 "\t/* get prototype */\n");
         outputf(outc,
                 "\tduk_get_global_string(ctx, %s_magic_string_prototypes);\n",
@@ -154,7 +154,7 @@ static int output_get_prototype(struct opctx *outc, const char *interface_name)
         outputf(outc,
                 "\tduk_get_prop_string(ctx, -1, \"%s\");\n",
                 proto_name);
-        outputf(outc,
+        outputs(outc,
                 "\tduk_replace(ctx, -2);\n");
 
         free(proto_name);
@@ -167,16 +167,16 @@ static int output_get_prototype(struct opctx *outc, const char *interface_name)
  */
 static int output_set_destructor(struct opctx *outc, char *class_name, int idx)
 {
-        outputf(outc,
+        outputs(outc,
                 "\t/* Set the destructor */\n");
         outputf(outc,
                 "\tduk_dup(ctx, %d);\n", idx);
         outputf(outc,
                 "\tduk_push_c_function(ctx, %s_%s___destructor, 1);\n",
                 DLPFX, class_name);
-        outputf(outc,
+        outputs(outc,
                 "\tduk_set_finalizer(ctx, -2);\n");
-        outputf(outc,
+        outputs(outc,
                 "\tduk_pop(ctx);\n\n");
 
         return 0;
@@ -188,7 +188,7 @@ static int output_set_destructor(struct opctx *outc, char *class_name, int idx)
 static int
 output_set_constructor(struct opctx *outc, char *class_name, int idx, int argc)
 {
-        outputf(outc,
+        outputs(outc,
                 "\t/* Set the constructor */\n");
         outputf(outc,
                 "\tduk_dup(ctx, %d);\n", idx);
@@ -198,7 +198,7 @@ output_set_constructor(struct opctx *outc, char *class_name, int idx, int argc)
         outputf(outc,
                 "\tduk_put_prop_string(ctx, -2, \"%sINIT\");\n",
                 MAGICPFX);
-        outputf(outc,
+        outputs(outc,
                 "\tduk_pop(ctx);\n\n");
 
         return 0;
@@ -213,11 +213,11 @@ output_dump_stack(struct opctx *outc)
 {
         if (options->dbglog) {
                 /* dump stack */
-                outputf(outc,
+                outputs(outc,
                         "\tduk_push_context_dump(ctx);\n");
-                outputf(outc,
-                        "\tNSLOG(dukky, DEEPDEBUG, \"Stack: %%s\", duk_to_string(ctx, -1));\n");
-                outputf(outc,
+                outputs(outc,
+                        "\tNSLOG(dukky, DEEPDEBUG, \"Stack: %s\", duk_to_string(ctx, -1));\n");
+                outputs(outc,
                         "\tduk_pop(ctx);\n");
         }
         return 0;
@@ -232,9 +232,9 @@ output_add_method(struct opctx *outc,
                   const char *class_name,
                   const char *method)
 {
-        outputf(outc,
+        outputs(outc,
                 "\t/* Add a method */\n");
-        outputf(outc,
+        outputs(outc,
                 "\tduk_dup(ctx, 0);\n");
         outputf(outc,
                 "\tduk_push_string(ctx, \"%s\");\n", method);
@@ -242,19 +242,19 @@ output_add_method(struct opctx *outc,
                 "\tduk_push_c_function(ctx, %s_%s_%s, DUK_VARARGS);\n",
                 DLPFX, class_name, method);
         output_dump_stack(outc);
-        outputf(outc,
+        outputs(outc,
                 "\tduk_def_prop(ctx, -3,\n");
-        outputf(outc,
+        outputs(outc,
                 "\t\t     DUK_DEFPROP_HAVE_VALUE |\n");
-        outputf(outc,
+        outputs(outc,
                 "\t\t     DUK_DEFPROP_HAVE_WRITABLE |\n");
-        outputf(outc,
+        outputs(outc,
                 "\t\t     DUK_DEFPROP_HAVE_ENUMERABLE |\n");
-        outputf(outc,
+        outputs(outc,
                 "\t\t     DUK_DEFPROP_ENUMERABLE |\n");
-        outputf(outc,
+        outputs(outc,
                 "\t\t     DUK_DEFPROP_HAVE_CONFIGURABLE);\n");
-        outputf(outc,
+        outputs(outc,
                 "\tduk_pop(ctx);\n\n");
 
         return 0;
@@ -268,9 +268,9 @@ output_populate_rw_property(struct opctx *outc,
                             const char *class_name,
                             const char *property)
 {
-        outputf(outc,
+        outputs(outc,
                 "\t/* Add read/write property */\n");
-        outputf(outc,
+        outputs(outc,
                 "\tduk_dup(ctx, 0);\n");
         outputf(outc,
                 "\tduk_push_string(ctx, \"%s\");\n", property);
@@ -281,15 +281,15 @@ output_populate_rw_property(struct opctx *outc,
                 "\tduk_push_c_function(ctx, %s_%s_%s_setter, 1);\n",
                 DLPFX, class_name, property);
         output_dump_stack(outc);
-        outputf(outc,
+        outputs(outc,
                 "\tduk_def_prop(ctx, -4, DUK_DEFPROP_HAVE_GETTER |\n");
-        outputf(outc,
+        outputs(outc,
                 "\t\tDUK_DEFPROP_HAVE_SETTER |\n");
-        outputf(outc,
+        outputs(outc,
                 "\t\tDUK_DEFPROP_HAVE_ENUMERABLE | DUK_DEFPROP_ENUMERABLE |\n");
-        outputf(outc,
+        outputs(outc,
                 "\t\tDUK_DEFPROP_HAVE_CONFIGURABLE);\n");
-        outputf(outc,
+        outputs(outc,
                 "\tduk_pop(ctx);\n\n");
 
         return 0;
@@ -304,9 +304,9 @@ output_populate_ro_property(struct opctx *outc,
                             const char *class_name,
                             const char *property)
 {
-        outputf(outc,
+        outputs(outc,
                 "\t/* Add readonly property */\n");
-        outputf(outc,
+        outputs(outc,
                 "\tduk_dup(ctx, 0);\n");
         outputf(outc,
                 "\tduk_push_string(ctx, \"%s\");\n", property);
@@ -314,13 +314,13 @@ output_populate_ro_property(struct opctx *outc,
                 "\tduk_push_c_function(ctx, %s_%s_%s_getter, 0);\n",
                 DLPFX, class_name, property);
         output_dump_stack(outc);
-        outputf(outc,
+        outputs(outc,
                 "\tduk_def_prop(ctx, -3, DUK_DEFPROP_HAVE_GETTER |\n");
-        outputf(outc,
+        outputs(outc,
                 "\t\tDUK_DEFPROP_HAVE_ENUMERABLE | DUK_DEFPROP_ENUMERABLE |\n");
-        outputf(outc,
+        outputs(outc,
                 "\t\tDUK_DEFPROP_HAVE_CONFIGURABLE);\n");
-        outputf(outc,
+        outputs(outc,
                 "\tduk_pop(ctx);\n\n");
 
         return 0;
@@ -335,23 +335,23 @@ output_prototype_constant_int(struct opctx *outc,
                               const char *constant_name,
                               int value)
 {
-        outputf(outc,
+        outputs(outc,
                 "\tduk_dup(ctx, 0);\n");
         outputf(outc,
                 "\tduk_push_string(ctx, \"%s\");\n", constant_name);
         outputf(outc,
                 "\tduk_push_int(ctx, %d);\n", value);
-        outputf(outc,
+        outputs(outc,
                 "\tduk_def_prop(ctx, -3, DUK_DEFPROP_HAVE_VALUE |\n");
-        outputf(outc,
+        outputs(outc,
                 "\t\t     DUK_DEFPROP_HAVE_WRITABLE |\n");
-        outputf(outc,
+        outputs(outc,
                 "\t\t     DUK_DEFPROP_HAVE_ENUMERABLE |\n");
-        outputf(outc,
+        outputs(outc,
                 "\t\t     DUK_DEFPROP_ENUMERABLE |\n");
-        outputf(outc,
+        outputs(outc,
                 "\t\t     DUK_DEFPROP_HAVE_CONFIGURABLE);\n");
-        outputf(outc,
+        outputs(outc,
                 "\tduk_pop(ctx);\n\n");
         return 0;
 }
@@ -363,33 +363,33 @@ output_prototype_constant_int(struct opctx *outc,
 static int
 output_get_method_private(struct opctx *outc, char *class_name, bool is_global)
 {
-        outputf(outc,
+        outputs(outc,
                 "\t/* Get private data for method */\n");
         outputf(outc,
                 "\t%s_private_t *priv = NULL;\n", class_name);
         if (is_global) {
-                outputf(outc,
+                outputs(outc,
                         "\tduk_push_global_object(ctx);\n");
         } else {
-                outputf(outc,
+                outputs(outc,
                         "\tduk_push_this(ctx);\n");
         }
         outputf(outc,
                 "\tduk_get_prop_string(ctx, -1, %s_magic_string_private);\n",
                 DLPFX);
-        outputf(outc,
+        outputs(outc,
                 "\tpriv = duk_get_pointer(ctx, -1);\n");
-        outputf(outc,
+        outputs(outc,
                 "\tduk_pop_2(ctx);\n");
-        outputf(outc,
+        outputs(outc,
                 "\tif (priv == NULL) {\n");
         if (options->dbglog) {
-                outputf(outc,
+                outputs(outc,
                         "\t\tNSLOG(dukky, INFO, \"priv failed\");\n");
         }
-        outputf(outc,
+        outputs(outc,
                 "\t\treturn 0; /* can do? No can do. */\n");
-        outputf(outc,
+        outputs(outc,
                 "\t}\n\n");
 
         return 0;
@@ -408,7 +408,7 @@ output_interface_constructor(struct opctx *outc, struct ir_entry *interfacee)
         outputf(outc,
                 "static duk_ret_t %s_%s___constructor(duk_context *ctx)\n",
                 DLPFX, interfacee->class_name);
-        outputf(outc,
+        outputs(outc,
                 "{\n");
 
         output_create_private(outc, interfacee->class_name);
@@ -424,14 +424,14 @@ output_interface_constructor(struct opctx *outc, struct ir_entry *interfacee)
                         ", duk_get_pointer(ctx, %d)",
                         init_argc);
         }
-        outputf(outc,
+        outputs(outc,
                 ");\n");
 
-        outputf(outc,
+        outputs(outc,
                 "\tduk_set_top(ctx, 1);\n");
-        outputf(outc,
+        outputs(outc,
                 "\treturn 1;\n");
-        outputf(outc,
+        outputs(outc,
                 "}\n\n");
 
         return 0;
@@ -448,7 +448,7 @@ output_interface_destructor(struct opctx *outc, struct ir_entry *interfacee)
         outputf(outc,
                 "static duk_ret_t %s_%s___destructor(duk_context *ctx)\n",
                 DLPFX, interfacee->class_name);
-        outputf(outc,
+        outputs(outc,
                 "{\n");
 
         output_safe_get_private(outc, interfacee->class_name, 0);
@@ -458,12 +458,12 @@ output_interface_destructor(struct opctx *outc, struct ir_entry *interfacee)
                 "\t%s_%s___fini(ctx, priv);\n",
                 DLPFX, interfacee->class_name);
 
-        outputf(outc,
+        outputs(outc,
                 "\tfree(priv);\n");
-        outputf(outc,
+        outputs(outc,
                 "\treturn 0;\n");
 
-        outputf(outc,
+        outputs(outc,
                 "}\n\n");
 
         return 0;
@@ -533,7 +533,7 @@ output_interface_inherit_init(struct opctx *outc,
                                 param_name);
                         return -1;
                 } else {
-                        outputf(outc, ", ");
+                        outputs(outc, ", ");
 
                         /* cast the parameter if required */
                         if (compare_ctypes(param_node,
@@ -552,7 +552,7 @@ output_interface_inherit_init(struct opctx *outc,
                         inh_param_node, GENBIND_NODE_TYPE_METHOD);
         }
 
-        outputf(outc, ");\n");
+        outputs(outc, ");\n");
 
         return 0;
 }
@@ -565,24 +565,20 @@ output_interface_init_declaration(struct opctx *outc,
 {
         struct genbind_node *param_node;
 
-        if  (interfacee->refcount == 0) {
-                outputf(outc, "static ");
+        if  (interfacee->local_init) {
+                outputs(outc, "static ");
         }
 
         outputf(outc,
                 "void %s_%s___init(duk_context *ctx, %s_private_t *priv",
                 DLPFX, interfacee->class_name, interfacee->class_name);
 
-        /* count the number of arguments on the initializer */
-        interfacee->class_init_argc = 0;
-
         /* output the paramters on the method (if any) */
         param_node = genbind_node_find_type(
                 genbind_node_getnode(init_node),
                 NULL, GENBIND_NODE_TYPE_PARAMETER);
         while (param_node != NULL) {
-                interfacee->class_init_argc++;
-                outputf(outc, ", ");
+                outputs(outc, ", ");
 
                 output_ctype(outc, param_node, true);
 
@@ -616,7 +612,7 @@ output_interface_init(struct opctx *outc,
         /* initialisor definition */
         output_interface_init_declaration(outc, interfacee, init_node);
 
-        outputf(outc, "\n{\n");
+        outputs(outc, "\n{\n");
 
         /* if this interface inherits ensure we call its initialisor */
         res = output_interface_inherit_init(outc, interfacee, inherite);
@@ -626,14 +622,14 @@ output_interface_init(struct opctx *outc,
 
         /* generate log statement */
         if (options->dbglog) {
-                outputf(outc,
-                        "\tNSLOG(dukky, INFO, \"Initialise %%p (priv=%%p)\", duk_get_heapptr(ctx, 0), priv);\n" );
+                outputs(outc,
+                        "\tNSLOG(dukky, INFO, \"Initialise %p (priv=%p)\", duk_get_heapptr(ctx, 0), priv);\n" );
         }
 
         /* output the initaliser code from the binding */
         output_ccode(outc, init_node);
 
-        outputf(outc, "}\n\n");
+        outputs(outc, "}\n\n");
 
         return 0;
 
@@ -656,18 +652,18 @@ output_interface_fini(struct opctx *outc,
                                              GENBIND_METHOD_TYPE_FINI);
 
         /* finaliser definition */
-        if  (interfacee->refcount == 0) {
-                outputf(outc, "static ");
+        if  (interfacee->local_init) {
+                outputs(outc, "static ");
         }
         outputf(outc,
                 "void %s_%s___fini(duk_context *ctx, %s_private_t *priv)\n",
                 DLPFX, interfacee->class_name, interfacee->class_name);
-        outputf(outc, "{\n");
+        outputs(outc, "{\n");
 
         /* generate log statement */
         if (options->dbglog) {
-                outputf(outc,
-                        "\tNSLOG(dukky, INFO, \"Finalise %%p\", duk_get_heapptr(ctx, 0));\n" );
+                outputs(outc,
+                        "\tNSLOG(dukky, INFO, \"Finalise %p\", duk_get_heapptr(ctx, 0));\n" );
         }
 
         /* output the finialisor code from the binding */
@@ -679,7 +675,7 @@ output_interface_fini(struct opctx *outc,
                         "\t%s_%s___fini(ctx, &priv->parent);\n",
                         DLPFX, inherite->class_name);
         }
-        outputf(outc, "}\n\n");
+        outputs(outc, "}\n\n");
 
         return 0;
 }
@@ -701,7 +697,7 @@ output_prototype_method(struct opctx *outc,
                                   operatione->name);
         } else {
                 /* special method on prototype */
-                outputf(outc,
+                outputs(outc,
                      "\t/* Special method on prototype - UNIMPLEMENTED */\n\n");
         }
 
@@ -775,22 +771,22 @@ output_prototype_attributes(struct opctx *outc, struct ir_entry *entry)
 /**
  * output constants on the prototype
  *
- * \todo This implementation assumes the constant is a literal int and should
- * check the type node base value.
+ * \todo This implementation only handles integer constants.
  */
 static int
 output_prototype_constant(struct opctx *outc,
                           struct ir_constant_entry *constante)
 {
-        int *value;
-
-        value = webidl_node_getint(
-                webidl_node_find_type(
-                        webidl_node_getnode(constante->node),
-                        NULL,
-                        WEBIDL_NODE_TYPE_LITERAL_INT));
+        if (constante->value.type != IR_LITERAL_INT) {
+                WARN(WARNING_UNIMPLEMENTED,
+                     "Constant %s is not an integer",
+                     constante->name);
+                return 0;
+        }
 
-        output_prototype_constant_int(outc, constante->name, *value);
+        output_prototype_constant_int(outc,
+                                      constante->name,
+                                      constante->value.number);
 
         return 0;
 }
@@ -825,7 +821,7 @@ output_global_create_prototype(struct opctx *outc,
 {
         int idx;
 
-        outputf(outc,
+        outputs(outc,
                 "\t/* Create interface objects */\n");
         for (idx = 0; idx < ir->entryc; idx++) {
                 struct ir_entry *entry;
@@ -839,7 +835,7 @@ output_global_create_prototype(struct opctx *outc,
                         }
 
                         if (entry == interfacee) {
-                                outputf(outc,
+                                outputs(outc,
                                         "\tduk_dup(ctx, 0);\n");
                         } else {
                                 output_get_prototype(outc, entry->name);
@@ -874,20 +870,20 @@ output_interface_prototype(struct opctx *outc,
         outputf(outc,
                 "duk_ret_t %s_%s___proto(duk_context *ctx, void *udata)\n",
                 DLPFX, interfacee->class_name);
-        outputf(outc, "{\n");
+        outputs(outc, "{\n");
 
         /* Output any binding data first */
         if (output_cdata(outc, proto_node, GENBIND_NODE_TYPE_CDATA) != 0) {
-                outputf(outc,
+                outputs(outc,
                         "\n");
         }
 
         /* generate prototype chaining if interface has a parent */
         if (inherite != NULL) {
-                outputf(outc,
+                outputs(outc,
                       "\t/* Set this prototype's prototype (left-parent) */\n");
                 output_get_prototype(outc, inherite->name);
-                outputf(outc,
+                outputs(outc,
                         "\tduk_set_prototype(ctx, 0);\n\n");
         }
 
@@ -916,10 +912,10 @@ output_interface_prototype(struct opctx *outc,
                                0,
                                interfacee->class_init_argc);
 
-        outputf(outc,
+        outputs(outc,
                 "\treturn 1; /* The prototype object */\n");
 
-        outputf(outc,
+        outputs(outc,
                 "}\n\n");
 
         return 0;
@@ -940,7 +936,7 @@ output_interface_elipsis_operation(struct opctx *outc,
         outputf(outc,
                 "static duk_ret_t %s_%s_%s(duk_context *ctx)\n",
                 DLPFX, interfacee->class_name, operatione->name);
-        outputf(outc,
+        outputs(outc,
                 "{\n");
 
         /**
@@ -960,11 +956,11 @@ output_interface_elipsis_operation(struct opctx *outc,
                 WARN(WARNING_UNIMPLEMENTED,
                      "Unimplemented: method %s::%s();",
                      interfacee->name, operatione->name);
-                outputf(outc,
+                outputs(outc,
                         "\treturn 0;\n");
         }
 
-        outputf(outc,
+        outputs(outc,
                 "}\n\n");
 
         return 0;
@@ -985,7 +981,7 @@ output_interface_overloaded_operation(struct opctx *outc,
         outputf(outc,
                 "static duk_ret_t %s_%s_%s(duk_context *ctx)\n",
                 DLPFX, interfacee->class_name, operatione->name);
-        outputf(outc,
+        outputs(outc,
                 "{\n");
 
         /** \todo This is where the checking of the parameters to the
@@ -1004,11 +1000,11 @@ output_interface_overloaded_operation(struct opctx *outc,
                 WARN(WARNING_UNIMPLEMENTED,
                      "Unimplemented: method %s::%s();",
                      interfacee->name, operatione->name);
-                outputf(outc,
+                outputs(outc,
                         "\treturn 0;\n");
         }
 
-        outputf(outc,
+        outputs(outc,
                 "}\n\n");
 
         return 0;
@@ -1024,7 +1020,7 @@ output_interface_special_operation(struct opctx *outc,
                                    struct ir_operation_entry *operatione)
 {
         /* special method definition */
-        outputf(outc,
+        outputs(outc,
                 "/* Special method definition - UNIMPLEMENTED */\n\n");
 
         WARN(WARNING_UNIMPLEMENTED,
@@ -1048,59 +1044,38 @@ output_operation_optional_defaults(
         int argc;
         for (argc = 0; argc < argumentc; argc++) {
                 struct ir_operation_argument_entry *cure;
-                struct webidl_node *lit_node; /* literal node */
-                enum webidl_node_type lit_type;
-                int *lit_int;
-                char *lit_str;
 
                 cure = argumentv + argc;
 
-                lit_node = webidl_node_getnode(
-                        webidl_node_find_type(
-                                webidl_node_getnode(cure->node),
-                                NULL,
-                                WEBIDL_NODE_TYPE_OPTIONAL));
-
-                if (lit_node != NULL) {
-
-                        lit_type = webidl_node_gettype(lit_node);
-
-                        switch (lit_type) {
-                        case WEBIDL_NODE_TYPE_LITERAL_NULL:
-                                outputf(outc,
-                                        "\t\tduk_push_null(ctx);\n");
-                                break;
-
-                        case WEBIDL_NODE_TYPE_LITERAL_INT:
-                                lit_int = webidl_node_getint(lit_node);
-                                outputf(outc,
-                                        "\t\tduk_push_int(ctx, %d);\n",
-                                        *lit_int);
-                                break;
-
-                        case WEBIDL_NODE_TYPE_LITERAL_BOOL:
-                                lit_int = webidl_node_getint(lit_node);
-                                outputf(outc,
-                                        "\t\tduk_push_boolean(ctx, %d);\n",
-                                        *lit_int);
-                                break;
-
-                        case WEBIDL_NODE_TYPE_LITERAL_STRING:
-                                lit_str = webidl_node_gettext(lit_node);
-                                outputf(outc,
-                                        "\t\tduk_push_string(ctx, \"%s\");\n",
-                                        lit_str);
-                                break;
-
-                        case WEBIDL_NODE_TYPE_LITERAL_FLOAT:
-                        default:
-                                outputf(outc,
-                                        "\t\tduk_push_undefined(ctx);\n");
-                                break;
-                        }
-                } else {
+                switch (cure->defl.type) {
+                case IR_LITERAL_NULL:
+                        outputs(outc,
+                                "\t\tduk_push_null(ctx);\n");
+                        break;
+
+                case IR_LITERAL_INT:
+                        outputf(outc,
+                                "\t\tduk_push_int(ctx, %d);\n",
+                                cure->defl.number);
+                        break;
+
+                case IR_LITERAL_BOOL:
+                        outputf(outc,
+                                "\t\tduk_push_boolean(ctx, %d);\n",
+                                cure->defl.number);
+                        break;
+
+                case IR_LITERAL_STRING:
                         outputf(outc,
+                                "\t\tduk_push_string(ctx, \"%s\");\n",
+                                cure->defl.text);
+                        break;
+
+                case IR_LITERAL_FLOAT:
+                default:
+                        outputs(outc,
                                 "\t\tduk_push_undefined(ctx);\n");
+                        break;
                 }
         }
         return 0;
@@ -1116,17 +1091,11 @@ output_operation_argument_type_check(
         int argidx)
 {
         struct ir_operation_argument_entry *argumente;
-        struct webidl_node *type_node;
-        enum webidl_type *argument_type;
+        enum webidl_type argument_type;
 
         argumente = overloade->argumentv + argidx;
 
-        type_node = webidl_node_find_type(
-                webidl_node_getnode(argumente->node),
-                NULL,
-                WEBIDL_NODE_TYPE_TYPE);
-
-        if (type_node == NULL) {
+        if (argumente->typec == 0) {
                 fprintf(stderr, "%s:%s %dth argument %s has no type\n",
                         interfacee->name,
                         operatione->name,
@@ -1135,13 +1104,7 @@ output_operation_argument_type_check(
                 return -1;
         }
 
-        argument_type = (enum webidl_type *)webidl_node_getint(
-                webidl_node_find_type(
-                        webidl_node_getnode(type_node),
-                        NULL,
-                        WEBIDL_NODE_TYPE_TYPE_BASE));
-
-        if (argument_type == NULL) {
+        if (argumente->typev[0].nobase) {
                 fprintf(stderr,
                         "%s:%s %dth argument %s has no type base\n",
                         interfacee->name,
@@ -1151,7 +1114,9 @@ output_operation_argument_type_check(
                 return -1;
         }
 
-        if (*argument_type == WEBIDL_TYPE_ANY) {
+        argument_type = argumente->typev[0].base;
+
+        if (argument_type == WEBIDL_TYPE_ANY) {
                 /* allowing any type needs no check */
                 return 0;
         }
@@ -1159,7 +1124,7 @@ output_operation_argument_type_check(
         outputf(outc,
                 "\tif (%s_argc > %d) {\n", DLPFX, argidx);
 
-        switch (*argument_type) {
+        switch (argument_type) {
         case WEBIDL_TYPE_STRING:
                 /* coerce values to string */
                 outputf(outc,
@@ -1189,11 +1154,11 @@ output_operation_argument_type_check(
 
 
         default:
-                outputf(outc,
+                outputs(outc,
                         "\t\t/* unhandled type check */\n");
         }
 
-        outputf(outc,
+        outputs(outc,
                 "\t}\n");
 
         return 0;
@@ -1238,7 +1203,7 @@ output_interface_operation(struct opctx *outc,
         outputf(outc,
                 "static duk_ret_t %s_%s_%s(duk_context *ctx)\n",
                 DLPFX, interfacee->class_name, operatione->name);
-        outputf(outc,
+        outputs(outc,
                 "{\n");
 
         /* check arguments */
@@ -1255,12 +1220,12 @@ output_interface_operation(struct opctx *outc,
                 outputf(outc,
                         "if (%s_argc < %d) {\n",
                         DLPFX, fixedargc);
-                outputf(outc,
+                outputs(outc,
                         "\t\t/* not enough arguments */\n");
                 outputf(outc,
                         "\t\treturn duk_error(ctx, DUK_RET_TYPE_ERROR, %s_error_fmt_argument, %d, %s_argc);\n",
                         DLPFX, fixedargc, DLPFX);
-                outputf(outc,
+                outputs(outc,
                         "\t} else ");
         }
 
@@ -1276,7 +1241,7 @@ output_interface_operation(struct opctx *outc,
                 output_operation_optional_defaults(outc,
                         overloade->argumentv + optargc,
                         overloade->argumentc - optargc);
-                outputf(outc,
+                outputs(outc,
                         "\t} else ");
         }
 
@@ -1288,12 +1253,12 @@ output_interface_operation(struct opctx *outc,
                 DLPFX,
                 overloade->argumentc,
                 overloade->argumentc);
-        outputf(outc,
+        outputs(outc,
                 "\n");
 
         /* generate argument type checks */
 
-        outputf(outc,
+        outputs(outc,
                 "\t/* check types of passed arguments are correct */\n");
 
         for (argidx = 0; argidx < overloade->argumentc; argidx++) {
@@ -1315,15 +1280,15 @@ output_interface_operation(struct opctx *outc,
                      interfacee->name, operatione->name);
 
                 if (options->dbglog) {
-                        outputf(outc,
+                        outputs(outc,
                               "\tNSLOG(dukky, WARNING, \"Unimplemented\");\n");
                 }
 
-                outputf(outc,
+                outputs(outc,
                         "\treturn 0;\n");
         }
 
-        outputf(outc,
+        outputs(outc,
                 "}\n\n");
 
         return 0;
@@ -1365,7 +1330,7 @@ output_attribute_getter(struct opctx *outc,
         outputf(outc,
                 "static duk_ret_t %s_%s_%s_getter(duk_context *ctx)\n",
                 DLPFX, interfacee->class_name, atributee->name);
-        outputf(outc,
+        outputs(outc,
                 "{\n");
 
         output_get_method_private(outc,
@@ -1383,7 +1348,7 @@ output_attribute_getter(struct opctx *outc,
                                                                 atributee);
                 }
                 if (res >= 0) {
-                        outputf(outc,
+                        outputs(outc,
                                 "}\n\n");
                         return res;
                 }
@@ -1407,11 +1372,11 @@ output_attribute_getter(struct opctx *outc,
              type_str);
 
         if (options->dbglog) {
-                outputf(outc,
+                outputs(outc,
                         "\tNSLOG(dukky, WARNING, \"Unimplemented\");\n" );
         }
 
-        outputf(outc,
+        outputs(outc,
                 "\treturn 0;\n"
                 "}\n\n");
 
@@ -1429,14 +1394,14 @@ output_putforwards_setter(struct opctx *outc,
 {
         /* generate autogenerated putforwards */
 
-        outputf(outc,
+        outputs(outc,
                 "\tduk_ret_t get_ret;\n\n");
 
         outputf(outc,
                 "\tget_ret = %s_%s_%s_getter(ctx);\n",
                 DLPFX, interfacee->class_name, atributee->name);
 
-        outputf(outc,
+        outputs(outc,
                 "\tif (get_ret != 1) {\n"
                 "\t\treturn 0;\n"
                 "\t}\n\n"
@@ -1449,7 +1414,7 @@ output_putforwards_setter(struct opctx *outc,
                 "\tduk_put_prop_string(ctx, -2, \"%s\");\n\n",
                 atributee->putforwards);
 
-        outputf(outc,
+        outputs(outc,
                 "\treturn 0;\n");
 
         return 0;
@@ -1470,7 +1435,7 @@ output_attribute_setter(struct opctx *outc,
         outputf(outc,
                 "static duk_ret_t %s_%s_%s_setter(duk_context *ctx)\n",
                 DLPFX, interfacee->class_name, atributee->name);
-        outputf(outc,
+        outputs(outc,
                 "{\n");
 
         output_get_method_private(outc,
@@ -1510,16 +1475,16 @@ output_attribute_setter(struct opctx *outc,
                      atributee->name,
                      type_str);
                 if (options->dbglog) {
-                        outputf(outc,
+                        outputs(outc,
                                "\tNSLOG(dukky, WARNING, \"Unimplemented\");\n");
                 }
 
                 /* no implementation so generate default */
-                outputf(outc,
+                outputs(outc,
                         "\treturn 0;\n");
         }
 
-        outputf(outc,
+        outputs(outc,
                 "}\n\n");
 
         return res;
@@ -1536,10 +1501,6 @@ output_interface_attribute(struct opctx *outc,
 {
         int res;
 
-        if (atributee->property_name == NULL) {
-            atributee->property_name = gen_idl2c_name(atributee->name);
-        }
-
         res = output_attribute_getter(outc, interfacee, atributee);
 
         /* only read/write and putforward attributes have a setter */
@@ -1571,59 +1532,57 @@ output_interface_attributes(struct opctx *outc, struct ir_entry *ife)
 }
 
 
-/*
- * generate a source file to implement an interface using duk and libdom.
- *
- * exported interface documented in duk-libdom.h
- */
-int output_interface(struct ir *ir, struct ir_entry *interfacee)
+/* exported function documented in duk-libdom.h */
+int
+output_interface_section(struct opctx *ifop,
+                         struct ir *ir,
+                         struct ir_entry *interfacee,
+                         bool standalone)
 {
-        struct opctx *ifop;
         struct ir_entry *inherite;
         int res = 0;
 
-        /* open the output */
-        res = output_open(interfacee->filename, &ifop);
-        if (res !=0 ) {
-                return res;
-        }
-
         /* find parent interface entry */
         inherite = ir_inherit_entry(ir, interfacee);
 
-        /* tool preface */
-        output_tool_preface(ifop);
+        if (standalone) {
+                /* tool preface */
+                output_tool_preface(ifop);
 
-        /* binding preface */
-        output_method_cdata(ifop,
-                            ir->binding_node,
-                            GENBIND_METHOD_TYPE_PREFACE);
+                /* binding preface */
+                output_method_cdata(ifop,
+                                    ir->binding_node,
+                                    GENBIND_METHOD_TYPE_PREFACE);
+        }
 
         /* class preface */
         output_method_cdata(ifop,
                             interfacee->class,
                             GENBIND_METHOD_TYPE_PREFACE);
 
-        /* tool prologue */
-        output_tool_prologue(ifop);
+        if (standalone) {
+                /* tool prologue */
+                output_tool_prologue(ifop);
+                output_tool_class_include(ifop, interfacee);
 
-        /* binding prologue */
-        output_method_cdata(ifop,
-                            ir->binding_node,
-                            GENBIND_METHOD_TYPE_PROLOGUE);
+                /* binding prologue */
+                output_method_cdata(ifop,
+                                    ir->binding_node,
+                                    GENBIND_METHOD_TYPE_PROLOGUE);
+        }
 
         /* class prologue */
         output_method_cdata(ifop,
                             interfacee->class,
                             GENBIND_METHOD_TYPE_PROLOGUE);
 
-        outputf(ifop,
+        outputs(ifop,
                 "\n");
 
         /* initialisor */
         res = output_interface_init(ifop, interfacee, inherite);
         if (res != 0) {
-                goto op_error;
+                return res;
         }
 
         /* finaliser */
@@ -1644,29 +1603,54 @@ int output_interface(struct ir *ir, struct ir_entry *interfacee)
         /* prototype */
         output_interface_prototype(ifop, ir, interfacee, inherite);
 
-        outputf(ifop, "\n");
+        outputs(ifop, "\n");
 
         /* class epilogue */
         output_method_cdata(ifop,
                             interfacee->class,
                             GENBIND_METHOD_TYPE_EPILOGUE);
 
-        /* binding epilogue */
-        output_method_cdata(ifop,
-                            ir->binding_node,
-                            GENBIND_METHOD_TYPE_EPILOGUE);
+        if (standalone) {
+                /* binding epilogue */
+                output_method_cdata(ifop,
+                                    ir->binding_node,
+                                    GENBIND_METHOD_TYPE_EPILOGUE);
+        }
 
         /* class postface */
         output_method_cdata(ifop,
                             interfacee->class,
                             GENBIND_METHOD_TYPE_POSTFACE);
 
-        /* binding postface */
-        output_method_cdata(ifop,
-                            ir->binding_node,
-                            GENBIND_METHOD_TYPE_POSTFACE);
+        if (standalone) {
+                /* binding postface */
+                output_method_cdata(ifop,
+                                    ir->binding_node,
+                                    GENBIND_METHOD_TYPE_POSTFACE);
+        }
+
+        return 0;
+}
+
+
+/*
+ * generate a source file to implement an interface using duk and libdom.
+ *
+ * exported interface documented in duk-libdom.h
+ */
+int output_interface(struct ir *ir, struct ir_entry *interfacee)
+{
+        struct opctx *ifop;
+        int res = 0;
+
+        /* open the output */
+        res = output_open(interfacee->filename, &ifop);
+        if (res !=0 ) {
+                return res;
+        }
+
+        res = output_interface_section(ifop, ir, interfacee, true);
 
-op_error:
         output_close(ifop);
 
         return res;
@@ -1691,12 +1675,13 @@ output_interface_declaration(struct opctx *outc, struct ir_entry *interfacee)
                 "duk_ret_t %s_%s___proto(duk_context *ctx, void *udata);\n",
                 DLPFX, interfacee->class_name);
 
-        /* if the interface has no references (no other interface inherits from
-         * it) there is no reason to export the initalisor/finaliser as no
-         * other class constructor/destructor should call them.
+        /* if the interface has no references outside the file it is
+         * output in (no interface in another file inherits from it) there
+         * is no reason to export the initalisor/finaliser as no other
+         * class constructor/destructor should call them.
          */
-        if (interfacee->refcount < 1) {
-                outputf(outc,
+        if (interfacee->local_init) {
+                outputs(outc,
                         "\n");
                 return 0;
         }
@@ -1714,7 +1699,7 @@ output_interface_declaration(struct opctx *outc, struct ir_entry *interfacee)
         /* initialisor definition */
         output_interface_init_declaration(outc, interfacee, init_node);
 
-        outputf(outc,
+        outputs(outc,
                 ";\n\n");
 
         return 0;
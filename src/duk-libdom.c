@@ -21,6 +21,9 @@
 #include "webidl-ast.h"
 #include "ir.h"
 #include "output.h"
+#include "threadpool.h"
+#include "manifest.h"
+#include "trace.h"
 #include "duk-libdom.h"
 
 /** prefix for all generated functions */
@@ -28,6 +31,47 @@
 
 #define MAGICPFX "\\xFF\\xFFNETSURF_DUKTAPE_"
 
+/** name of the manifest of generated outputs */
+#define MANIFEST_FILENAME "manifest"
+
+/** name of the output when every entry is amalgamated into one file */
+#define AMALGAMATION_FILENAME "binding_all.c"
+
+/** name of each output when the entries are split between shards */
+#define SHARD_FILENAME "binding_shard%u.c"
+
+/* weights of the output size estimate in bytes */
+#define ENTRY_SIZE_BASE 1000
+#define ENTRY_SIZE_ATTRIBUTE 1100
+#define ENTRY_SIZE_CONSTANT 140
+#define ENTRY_SIZE_OPERATION 650
+#define ENTRY_SIZE_OVERLOAD 2300
+#define ENTRY_SIZE_ARGUMENT 280
+#define ENTRY_SIZE_MEMBER 400
+
+#ifndef NSGENBIND_VERSION
+#define NSGENBIND_VERSION "unknown"
+#endif
+
+/**
+ * output file holding the implementation of several entries
+ */
+struct output_shard {
+        char *filename;
+        uint64_t hash; /**< hash of every input the output depends upon */
+        bool unchanged; /**< the output is already up to date */
+};
+
+/**
+ * context of the output generation jobs
+ */
+struct output_ctx {
+        struct ir *ir;
+        unsigned int shardc; /**< number of shards or 0 for a file per entry */
+        struct output_shard *shardv; /**< the shards */
+        size_t *sizev; /**< estimated output size of each entry */
+};
+
 /**
  * \todo Constructors
  * \todo dukky_inject_not_ctr as binding.c function
@@ -101,7 +145,7 @@ static struct opctx *open_header(struct ir *ir, const char *name)
 static int close_header(struct ir *ir, struct opctx *hdrc)
 {
         /* close header guard */
-        outputf(hdrc,
+        outputs(hdrc,
                 "\n#endif\n");
 
         /* binding postface */
@@ -115,6 +159,135 @@ static int close_header(struct ir *ir, struct opctx *hdrc)
 }
 
 
+/**
+ * check if an entry has an implementation generated for it
+ *
+ * interfaces marked no output have no implementation, private
+ * structure or prototype.
+ */
+static bool entry_has_output(struct ir_entry *irentry)
+{
+        return ((irentry->type != IR_ENTRY_TYPE_INTERFACE) ||
+                (!irentry->u.interface.noobject));
+}
+
+/**
+ * generate the private structure of an interface or dictionary
+ */
+static int
+output_private_struct(struct opctx *privc,
+                      struct ir *ir,
+                      struct ir_entry *interfacee)
+{
+        struct ir_entry *inherite;
+        struct genbind_node *priv_node;
+
+        switch (interfacee->type) {
+        case IR_ENTRY_TYPE_INTERFACE:
+                outputf(privc,
+                        "/* Private data for %s interface */\n",
+                        interfacee->name);
+                break;
+
+        case IR_ENTRY_TYPE_DICTIONARY:
+                outputf(privc,
+                        "/* Private data for %s dictionary */\n",
+                        interfacee->name);
+                break;
+        }
+
+        outputs(privc,
+                "typedef struct {\n");
+
+        /* find parent entry and include in private */
+        inherite = ir_inherit_entry(ir, interfacee);
+        if (inherite != NULL) {
+                outputf(privc,
+                        "\t%s_private_t parent;\n",
+                        inherite->class_name);
+        }
+
+        /* for each private variable on the class output it here. */
+        priv_node = genbind_node_find_type(
+                genbind_node_getnode(interfacee->class),
+                NULL,
+                GENBIND_NODE_TYPE_PRIVATE);
+        while (priv_node != NULL) {
+                outputc(privc, '\t');
+
+                output_ctype(privc, priv_node, true);
+
+                outputs(privc, ";\n");
+
+                priv_node = genbind_node_find_type(
+                        genbind_node_getnode(interfacee->class),
+                        priv_node,
+                        GENBIND_NODE_TYPE_PRIVATE);
+        }
+
+        outputf(privc,
+                "} __attribute__((aligned)) %s_private_t;\n\n",
+                interfacee->class_name);
+
+        return 0;
+}
+
+/**
+ * generate the declarations of an interface or dictionary
+ */
+static int
+output_prototype_declaration(struct opctx *protoc, struct ir_entry *entry)
+{
+        switch (entry->type) {
+        case IR_ENTRY_TYPE_INTERFACE:
+                output_interface_declaration(protoc, entry);
+                break;
+
+        case IR_ENTRY_TYPE_DICTIONARY:
+                output_dictionary_declaration(protoc, entry);
+                break;
+        }
+
+        return 0;
+}
+
+/**
+ * generate the include of one of the headers of every class
+ *
+ * \param hdrc The output context of the header.
+ * \param ir The intermediate representation.
+ * \param suffix The suffix of the class header to include.
+ */
+static int
+output_class_header_includes(struct opctx *hdrc,
+                             struct ir *ir,
+                             const char *suffix)
+{
+        char *fname;
+        int fnamel;
+        int idx;
+
+        for (idx = 0; idx < ir->entryc; idx++) {
+                struct ir_entry *entry;
+
+                entry = ir->entries + idx;
+                if (!entry_has_output(entry)) {
+                        continue;
+                }
+
+                fnamel = strlen(entry->class_name) + strlen(suffix) + 4;
+                fname = malloc(fnamel);
+                if (fname == NULL) {
+                        return -1;
+                }
+                snprintf(fname, fnamel, "%s_%s.h", entry->class_name, suffix);
+                output_tool_include(hdrc, fname);
+                free(fname);
+        }
+
+        return 0;
+}
+
 /**
  * generate private header
  */
@@ -127,67 +300,26 @@ output_private_header(struct ir *ir)
         /* open header */
         privc = open_header(ir, "private");
 
+        /* the structures are in the header of each class */
+        if (options->classheaders) {
+                output_class_header_includes(privc, ir, "private");
+                close_header(ir, privc);
+                return 0;
+        }
+
         for (idx = 0; idx < ir->entryc; idx++) {
                 struct ir_entry *interfacee;
-                struct ir_entry *inherite;
-                struct genbind_node *priv_node;
 
                 interfacee = ir->entries + idx;
 
                 /* do not generate private structs for interfaces marked no
                  * output
                  */
-                if ((interfacee->type == IR_ENTRY_TYPE_INTERFACE) &&
-                    (interfacee->u.interface.noobject)) {
+                if (!entry_has_output(interfacee)) {
                         continue;
                 }
 
-                switch (interfacee->type) {
-                case IR_ENTRY_TYPE_INTERFACE:
-                        outputf(privc,
-                                "/* Private data for %s interface */\n",
-                                interfacee->name);
-                        break;
-
-                case IR_ENTRY_TYPE_DICTIONARY:
-                        outputf(privc,
-                                "/* Private data for %s dictionary */\n",
-                                interfacee->name);
-                        break;
-                }
-
-                outputf(privc,
-                        "typedef struct {\n");
-
-                /* find parent entry and include in private */
-                inherite = ir_inherit_entry(ir, interfacee);
-                if (inherite != NULL) {
-                        outputf(privc,
-                                "\t%s_private_t parent;\n",
-                                inherite->class_name);
-                }
-
-                /* for each private variable on the class output it here. */
-                priv_node = genbind_node_find_type(
-                        genbind_node_getnode(interfacee->class),
-                        NULL,
-                        GENBIND_NODE_TYPE_PRIVATE);
-                while (priv_node != NULL) {
-                        outputc(privc, '\t');
-
-                        output_ctype(privc, priv_node, true);
-
-                        outputf(privc, ";\n");
-
-                        priv_node = genbind_node_find_type(
-                                genbind_node_getnode(interfacee->class),
-                                priv_node,
-                                GENBIND_NODE_TYPE_PRIVATE);
-                }
-
-                outputf(privc,
-                        "} __attribute__((aligned)) %s_private_t;\n\n",
-                        interfacee->class_name);
+                output_private_struct(privc, ir, interfacee);
         }
 
         close_header(ir, privc);
@@ -207,23 +339,87 @@ output_prototype_header(struct ir *ir)
         /* open header */
         protoc = open_header(ir, "prototype");
 
+        /* the declarations are in the header of each class */
+        if (options->classheaders) {
+                output_class_header_includes(protoc, ir, "prototype");
+                close_header(ir, protoc);
+                return 0;
+        }
+
         for (idx = 0; idx < ir->entryc; idx++) {
-                struct ir_entry *entry;
+                output_prototype_declaration(protoc, ir->entries + idx);
+        }
 
-                entry = ir->entries + idx;
+        close_header(ir, protoc);
 
-                switch (entry->type) {
-                case IR_ENTRY_TYPE_INTERFACE:
-                        output_interface_declaration(protoc, entry);
-                        break;
+        return 0;
+}
 
-                case IR_ENTRY_TYPE_DICTIONARY:
-                        output_dictionary_declaration(protoc, entry);
-                        break;
-                }
+/**
+ * generate the headers of a class
+ *
+ * The private header holds the private structure of the class and the
+ * prototype header the declarations of its functions. Each includes
+ * the header of the class it inherits from so a source only depends on
+ * the headers of its own inheritance chain. Headers are only written
+ * when their contents change so altering a class only causes the
+ * sources of it and the classes which inherit from it to be rebuilt.
+ */
+static int output_class_headers(struct ir *ir, struct ir_entry *irentry)
+{
+        struct ir_entry *inherite;
+        struct opctx *hdrc;
+        char *name;
+        int namel;
+
+        if (!entry_has_output(irentry)) {
+                return 0;
         }
 
-        close_header(ir, protoc);
+        inherite = ir_inherit_entry(ir, irentry);
+        if ((inherite != NULL) && !entry_has_output(inherite)) {
+                inherite = NULL;
+        }
+
+        namel = strlen(irentry->class_name) + SLEN("_prototype") + 1;
+        name = malloc(namel);
+        if (name == NULL) {
+                return -1;
+        }
+
+        /* private header */
+        snprintf(name, namel, "%s_private", irentry->class_name);
+        hdrc = open_header(ir, name);
+        if (hdrc == NULL) {
+                free(name);
+                return -1;
+        }
+        if (inherite != NULL) {
+                snprintf(name, namel, "%s_private.h", inherite->class_name);
+                output_tool_include(hdrc, name);
+                outputc(hdrc, '\n');
+        }
+        output_private_struct(hdrc, ir, irentry);
+        close_header(ir, hdrc);
+
+        /* prototype header */
+        snprintf(name, namel, "%s_prototype", irentry->class_name);
+        hdrc = open_header(ir, name);
+        if (hdrc == NULL) {
+                free(name);
+                return -1;
+        }
+        snprintf(name, namel, "%s_private.h", irentry->class_name);
+        output_tool_include(hdrc, name);
+        if (inherite != NULL) {
+                snprintf(name, namel, "%s_prototype.h", inherite->class_name);
+                output_tool_include(hdrc, name);
+        }
+        outputc(hdrc, '\n');
+        output_prototype_declaration(hdrc, irentry);
+        close_header(ir, hdrc);
+
+        free(name);
 
         return 0;
 }
@@ -232,38 +428,52 @@ output_prototype_header(struct ir *ir)
  * generate makefile fragment
  */
 static int
-output_makefile(struct ir *ir)
+output_makefile(struct output_ctx *ctx)
 {
+        struct ir *ir = ctx->ir;
+        unsigned int shard;
         int idx;
-        FILE *makef;
+        struct opctx *makef;
 
         /* open output file */
-        makef = genb_fopen_tmp("Makefile");
-        if (makef == NULL) {
+        if (output_open("Makefile", &makef) != 0) {
                 return -1;
         }
 
-        fprintf(makef, "# duk libdom makefile fragment\n\n");
+        outputs(makef, "# duk libdom makefile fragment\n\n");
 
-        fprintf(makef, "NSGENBIND_SOURCES:=binding.c ");
-        for (idx = 0; idx < ir->entryc; idx++) {
-                struct ir_entry *interfacee;
+        outputs(makef, "NSGENBIND_SOURCES:=binding.c ");
+        if (ctx->shardc > 0) {
+                /* the entries are all within the shards */
+                for (shard = 0; shard < ctx->shardc; shard++) {
+                        outputf(makef, "%s ", ctx->shardv[shard].filename);
+                }
+        } else {
+                for (idx = 0; idx < ir->entryc; idx++) {
+                        struct ir_entry *interfacee;
 
-                interfacee = ir->entries + idx;
+                        interfacee = ir->entries + idx;
 
-                /* no source for interfaces marked no output */
-                if ((interfacee->type == IR_ENTRY_TYPE_INTERFACE) &&
-                    (interfacee->u.interface.noobject)) {
-                        continue;
-                }
+                        /* no source for interfaces marked no output */
+                        if ((interfacee->type == IR_ENTRY_TYPE_INTERFACE) &&
+                            (interfacee->u.interface.noobject)) {
+                                continue;
+                        }
 
-                fprintf(makef, "%s ", interfacee->filename);
+                        outputf(makef, "%s ", interfacee->filename);
+                }
+        }
+        if (options->reproducible) {
+                /* the directory of the fragment as it is included */
+                outputs(makef,
+                        "\nNSGENBIND_PREFIX:=$(patsubst %/,%,$(dir $(lastword $(MAKEFILE_LIST))))\n");
+        } else {
+                outputf(makef,
+                        "\nNSGENBIND_PREFIX:=%s\n",
+                        options->outdirname);
         }
-        fprintf(makef, "\nNSGENBIND_PREFIX:=%s\n", options->outdirname);
-
-        genb_fclose_tmp(makef, "Makefile");
 
-        return 0;
+        return output_close(makef);
 }
 
 
@@ -354,6 +564,9 @@ output_binding_src(struct ir *ir)
 
         /* tool prologue */
         output_tool_prologue(bindc);
+        if (options->classheaders) {
+                output_tool_include(bindc, "prototype.h");
+        }
 
         /* binding prologue */
         output_method_cdata(bindc,
@@ -369,7 +582,7 @@ output_binding_src(struct ir *ir)
                 "const char *%s_error_fmt_number_type =\"argument %%d (%%s) requires a number\";\n",
                 DLPFX, DLPFX, DLPFX);
 
-        outputf(bindc, "\n");
+        outputs(bindc, "\n");
 
         outputf(bindc,
                 "/* Magic identifiers */\n"
@@ -377,7 +590,7 @@ output_binding_src(struct ir *ir)
                 "const char *%s_magic_string_prototypes =\"%sPROTOTYPES\";\n",
                 DLPFX, MAGICPFX, DLPFX, MAGICPFX);
 
-        outputf(bindc, "\n");
+        outputs(bindc, "\n");
 
 
         /* instanceof helper */
@@ -473,7 +686,7 @@ output_binding_src(struct ir *ir)
         outputf(bindc,
                 "duk_ret_t %s_create_prototypes(duk_context *ctx)\n", DLPFX);
 
-        outputf(bindc, "{\n");
+        outputs(bindc, "{\n");
 
         for (idx = 0; idx < ir->entryc; idx++) {
                 struct ir_entry *interfacee;
@@ -511,7 +724,7 @@ output_binding_src(struct ir *ir)
         }
 
         if (pglobale != NULL) {
-                outputf(bindc, "\n\t/* Global object prototype is last */\n");
+                outputs(bindc, "\n\t/* Global object prototype is last */\n");
 
                 proto_name = get_prototype_name(pglobale->name);
                 outputf(bindc,
@@ -524,9 +737,9 @@ output_binding_src(struct ir *ir)
                 free(proto_name);
         }
 
-        outputf(bindc, "\n\treturn DUK_ERR_NONE;\n");
+        outputs(bindc, "\n\treturn DUK_ERR_NONE;\n");
 
-        outputf(bindc, "}\n");
+        outputs(bindc, "}\n");
 
         /* binding postface */
         output_method_cdata(bindc,
@@ -538,104 +751,698 @@ output_binding_src(struct ir *ir)
         return 0;
 }
 
-static int output_interfaces_dictionaries(struct ir *ir)
+/**
+ * generate the output for a single interface or dictionary entry
+ */
+static int output_entry(struct ir *ir, struct ir_entry *irentry)
 {
-        int res;
+        int res = 0;
+        uint64_t start;
+
+        /* output is up to date from a previous run */
+        if (irentry->unchanged) {
+                return 0;
+        }
+
+        switch (irentry->type) {
+        case IR_ENTRY_TYPE_INTERFACE:
+                /* do not generate class for interfaces marked no
+                 * output
+                 */
+                if (!irentry->u.interface.noobject) {
+                        start = trace_start();
+                        res = output_interface(ir, irentry);
+                        trace_end(start, "output_interface", irentry->name);
+                }
+                break;
+
+        case IR_ENTRY_TYPE_DICTIONARY:
+                start = trace_start();
+                res = output_dictionary(ir, irentry);
+                trace_end(start, "output_dictionary", irentry->name);
+                break;
+
+        default:
+                break;
+        }
+
+        return res;
+}
+
+/**
+ * generate the output for the interfaces and dictionaries in a shard
+ *
+ * The tool and binding sections are generated once around the entries
+ * which are in the same order as the ir.
+ */
+static int output_shard(struct output_ctx *ctx, struct output_shard *shard)
+{
+        struct ir *ir = ctx->ir;
+        struct opctx *shardop;
+        int shardidx = shard - ctx->shardv;
         int idx;
+        int res = 0;
+        uint64_t start;
+
+        /* output is up to date from a previous run */
+        if (shard->unchanged) {
+                return 0;
+        }
+
+        start = trace_start();
+
+        res = output_open(shard->filename, &shardop);
+        if (res != 0) {
+                return res;
+        }
+
+        /* tool preface */
+        output_tool_preface(shardop);
+
+        /* binding preface */
+        output_method_cdata(shardop,
+                            ir->binding_node,
+                            GENBIND_METHOD_TYPE_PREFACE);
 
-        /* generate interfaces */
+        /* tool prologue */
+        output_tool_prologue(shardop);
         for (idx = 0; idx < ir->entryc; idx++) {
+                if (ir->entries[idx].shard == shardidx) {
+                        output_tool_class_include(shardop, ir->entries + idx);
+                }
+        }
+
+        /* binding prologue */
+        output_method_cdata(shardop,
+                            ir->binding_node,
+                            GENBIND_METHOD_TYPE_PROLOGUE);
+
+        for (idx = 0; (res == 0) && (idx < ir->entryc); idx++) {
                 struct ir_entry *irentry;
 
                 irentry = ir->entries + idx;
+                if (irentry->shard != shardidx) {
+                        continue;
+                }
 
-                switch (irentry->type) {
-                case IR_ENTRY_TYPE_INTERFACE:
-                        /* do not generate class for interfaces marked no
-                         * output
-                         */
-                        if (!irentry->u.interface.noobject) {
-                                res = output_interface(ir, irentry);
-                                if (res != 0) {
-                                        return res;
-                                }
-                        }
-                        break;
+                if (irentry->type == IR_ENTRY_TYPE_INTERFACE) {
+                        res = output_interface_section(shardop,
+                                                       ir,
+                                                       irentry,
+                                                       false);
+                } else {
+                        res = output_dictionary_section(shardop,
+                                                        ir,
+                                                        irentry,
+                                                        false);
+                }
+        }
 
-                case IR_ENTRY_TYPE_DICTIONARY:
-                        res = output_dictionary(ir, irentry);
-                        if (res != 0) {
-                                return res;
+        /* binding epilogue */
+        output_method_cdata(shardop,
+                            ir->binding_node,
+                            GENBIND_METHOD_TYPE_EPILOGUE);
+
+        /* binding postface */
+        output_method_cdata(shardop,
+                            ir->binding_node,
+                            GENBIND_METHOD_TYPE_POSTFACE);
+
+        output_close(shardop);
+
+        trace_end(start, "output_shard", shard->filename);
+
+        return res;
+}
+
+/**
+ * output files which are generated after the interfaces and dictionaries
+ */
+static int (* const output_binding_file[])(struct ir *ir) = {
+        output_private_header,
+        output_prototype_header,
+        output_binding_header,
+        output_binding_src,
+};
+
+#define OUTPUT_BINDING_FILE_COUNT \
+        (sizeof(output_binding_file) / sizeof(output_binding_file[0]))
+
+/**
+ * output job callback
+ *
+ * Jobs are numbered with each ir entry (or each shard) first followed
+ * by the headers of each entry (when each class has its own headers),
+ * the binding wide files and the makefile fragment which lists the
+ * sources. Every job writes a separate file and only reads the ir so
+ * they may be run concurrently.
+ */
+static int output_job(void *ctx, unsigned int job)
+{
+        struct output_ctx *opctx = ctx;
+        struct ir *ir = opctx->ir;
+        unsigned int sourcec;
+
+        if (opctx->shardc > 0) {
+                sourcec = opctx->shardc;
+                if (job < sourcec) {
+                        return output_shard(opctx, opctx->shardv + job);
+                }
+        } else {
+                sourcec = ir->entryc;
+                if (job < sourcec) {
+                        return output_entry(ir, ir->entries + job);
+                }
+        }
+
+        job -= sourcec;
+        if (options->classheaders) {
+                if (job < (unsigned int)ir->entryc) {
+                        return output_class_headers(ir, ir->entries + job);
+                }
+                job -= ir->entryc;
+        }
+
+        if (job < OUTPUT_BINDING_FILE_COUNT) {
+                return output_binding_file[job](ir);
+        }
+
+        return output_makefile(opctx);
+}
+
+/**
+ * estimate the size of the output for an entry
+ *
+ * Generating the output to measure it would cost as much as the build
+ * it is planning so the size is estimated from the ir instead. Every
+ * member generates a roughly fixed amount of glue and the binding code
+ * blocks are copied to the output verbatim.
+ *
+ * \param irentry The entry to estimate.
+ * \return the estimated size of the entry output in bytes
+ */
+static size_t entry_size(struct ir_entry *irentry)
+{
+        struct ir_interface_entry *interfacee;
+        struct ir_operation_entry *operatione;
+        size_t size;
+        int opidx;
+        int ovidx;
+
+        /* the binding code, including the methods, is output verbatim */
+        size = ENTRY_SIZE_BASE + genbind_node_textlen(irentry->class);
+
+        if (irentry->type == IR_ENTRY_TYPE_DICTIONARY) {
+                return size + (irentry->u.dictionary.memberc *
+                               ENTRY_SIZE_MEMBER);
+        }
+
+        interfacee = &irentry->u.interface;
+        size += interfacee->attributec * ENTRY_SIZE_ATTRIBUTE;
+        size += interfacee->constantc * ENTRY_SIZE_CONSTANT;
+        for (opidx = 0; opidx < interfacee->operationc; opidx++) {
+                operatione = interfacee->operationv + opidx;
+                size += ENTRY_SIZE_OPERATION;
+
+                /* more than one overload adds the dispatch code */
+                if (operatione->overloadc > 1) {
+                        size += operatione->overloadc * ENTRY_SIZE_OVERLOAD;
+                }
+                for (ovidx = 0; ovidx < operatione->overloadc; ovidx++) {
+                        size += operatione->overloadv[ovidx].argumentc *
+                                ENTRY_SIZE_ARGUMENT;
+                }
+        }
+
+        return size;
+}
+
+/**
+ * split the interfaces and dictionaries between the shards
+ *
+ * The entries are kept in ir order and divided into runs with close to
+ * the same estimated amount of output in each. An entry goes in the
+ * shard which holds the middle of its output. Keeping neighbouring entries together
+ * means most interfaces are in the same shard as those which inherit
+ * from them so their initialiser and finaliser need not be exported.
+ *
+ * \param ctx The output context to create the shards in.
+ * \return 0 on success else -1
+ */
+static int assign_shards(struct output_ctx *ctx)
+{
+        struct ir *ir = ctx->ir;
+        struct ir_entry *irentry;
+        struct ir_entry *inherite;
+        unsigned int shardc;
+        unsigned int outputc = 0;
+        unsigned int shard;
+        uint64_t total = 0;
+        uint64_t offset = 0;
+        int idx;
+
+        /* entries with output start in the first shard */
+        for (idx = 0; idx < ir->entryc; idx++) {
+                irentry = ir->entries + idx;
+
+                /* interfaces marked no output have no implementation */
+                if (((irentry->type == IR_ENTRY_TYPE_INTERFACE) &&
+                     (irentry->u.interface.noobject)) ||
+                    (irentry->filename == NULL)) {
+                        continue;
+                }
+
+                irentry->shard = 0;
+                outputc++;
+        }
+
+        /* no more shards than there are entries */
+        shardc = options->shards;
+        if (shardc > outputc) {
+                shardc = outputc;
+        }
+        if (shardc == 0) {
+                shardc = 1;
+        }
+
+        ctx->shardv = calloc(shardc, sizeof(struct output_shard));
+        ctx->sizev = calloc(ir->entryc + 1, sizeof(size_t));
+        if ((ctx->shardv == NULL) || (ctx->sizev == NULL)) {
+                return -1;
+        }
+        ctx->shardc = shardc;
+
+        for (shard = 0; shard < shardc; shard++) {
+                if (shardc == 1) {
+                        ctx->shardv[shard].filename = strdup(
+                                AMALGAMATION_FILENAME);
+                } else {
+                        ctx->shardv[shard].filename = malloc(
+                                sizeof(SHARD_FILENAME) + 10);
+                        if (ctx->shardv[shard].filename != NULL) {
+                                sprintf(ctx->shardv[shard].filename,
+                                        SHARD_FILENAME,
+                                        shard);
                         }
+                }
+                if (ctx->shardv[shard].filename == NULL) {
+                        return -1;
+                }
+        }
+
+        for (idx = 0; idx < ir->entryc; idx++) {
+                if (ir->entries[idx].shard != -1) {
+                        ctx->sizev[idx] = entry_size(ir->entries + idx);
+                        total += ctx->sizev[idx];
+                }
+        }
 
-                default:
-                        break;
+        for (idx = 0; idx < ir->entryc; idx++) {
+                irentry = ir->entries + idx;
+                if (irentry->shard == -1) {
+                        continue;
+                }
+
+                if (total > 0) {
+                        irentry->shard = ((offset + (ctx->sizev[idx] / 2)) *
+                                          shardc) / total;
+                }
+                offset += ctx->sizev[idx];
+
+                /* an interface is local until an interface in another
+                 * shard inherits from it
+                 */
+                irentry->local_init = true;
+        }
+
+        for (idx = 0; idx < ir->entryc; idx++) {
+                irentry = ir->entries + idx;
+                inherite = ir_inherit_entry(ir, irentry);
+                if ((inherite != NULL) &&
+                    (inherite->shard != irentry->shard)) {
+                        inherite->local_init = false;
+                }
+        }
+
+        if (options->verbose) {
+                for (shard = 0; shard < shardc; shard++) {
+                        uint64_t size = 0;
+
+                        outputc = 0;
+                        for (idx = 0; idx < ir->entryc; idx++) {
+                                if (ir->entries[idx].shard == (int)shard) {
+                                        size += ctx->sizev[idx];
+                                        outputc++;
+                                }
+                        }
+                        printf("%s: %u entries %llu bytes\n",
+                               ctx->shardv[shard].filename,
+                               outputc,
+                               (unsigned long long)size);
                 }
         }
 
         return 0;
 }
 
-int duk_libdom_output(struct ir *ir)
+static void free_shards(struct output_ctx *ctx)
 {
+        unsigned int shard;
+
+        if (ctx->shardv != NULL) {
+                for (shard = 0; shard < ctx->shardc; shard++) {
+                        free(ctx->shardv[shard].filename);
+                }
+        }
+        free(ctx->shardv);
+        free(ctx->sizev);
+}
+
+/**
+ * compute the output names and values for an entry
+ *
+ * These are computed for every entry before any output is generated as
+ * the output of an entry may refer to the values of others.
+ */
+static void prepare_entry(struct ir_entry *irentry)
+{
+        struct genbind_node *init_node;
         int idx;
-        int res = 0;
 
-        /* process ir entries for output */
+        /* the initialiser and finaliser are only exported if another
+         * interface inherits from this one
+         */
+        irentry->local_init = (irentry->refcount == 0);
+        irentry->shard = -1;
+
+        /* compute class name */
+        irentry->class_name = gen_idl2c_name(irentry->name);
+
+        if (irentry->class_name != NULL) {
+                int ifacenamelen;
+
+                /* generate source filename */
+                ifacenamelen = strlen(irentry->class_name) + 4;
+                irentry->filename = malloc(ifacenamelen);
+                snprintf(irentry->filename,
+                         ifacenamelen,
+                         "%s.c",
+                         irentry->class_name);
+        }
+
+        if (irentry->type != IR_ENTRY_TYPE_INTERFACE) {
+                return;
+        }
+
+        /* count the number of arguments on the initializer */
+        init_node = genbind_node_find_method(irentry->class,
+                                             NULL,
+                                             GENBIND_METHOD_TYPE_INIT);
+        irentry->class_init_argc = genbind_node_enumerate_type(
+                genbind_node_getnode(init_node),
+                GENBIND_NODE_TYPE_PARAMETER);
+
+        /* compute attribute property names */
+        for (idx = 0; idx < irentry->u.interface.attributec; idx++) {
+                struct ir_attribute_entry *atributee;
+
+                atributee = irentry->u.interface.attributev + idx;
+                atributee->property_name = gen_idl2c_name(atributee->name);
+        }
+}
+
+/**
+ * compute the hash of the inputs common to every entry
+ *
+ * This is the tool version, the options which alter the output (the
+ * output directory is used in include paths unless the output is
+ * reproducible) and the binding level methods which are output into
+ * every file.
+ */
+static uint64_t binding_hash(struct ir *ir)
+{
+        struct genbind_node *method_node;
+        uint64_t hash;
+
+        hash = genb_hash(GENB_HASH_INIT,
+                         NSGENBIND_VERSION,
+                         SLEN(NSGENBIND_VERSION));
+        hash = genb_hash(hash, &options->dbglog, sizeof(options->dbglog));
+        hash = genb_hash(hash,
+                         &options->classheaders,
+                         sizeof(options->classheaders));
+        hash = genb_hash(hash,
+                         &options->reproducible,
+                         sizeof(options->reproducible));
+        if (!options->reproducible) {
+                hash = genb_hash(hash,
+                                 options->outdirname,
+                                 strlen(options->outdirname) + 1);
+        }
+
+        method_node = genbind_node_find_type(
+                genbind_node_getnode(ir->binding_node),
+                NULL,
+                GENBIND_NODE_TYPE_METHOD);
+        while (method_node != NULL) {
+                hash = genbind_node_hash(method_node, hash);
+
+                method_node = genbind_node_find_type(
+                        genbind_node_getnode(ir->binding_node),
+                        method_node,
+                        GENBIND_NODE_TYPE_METHOD);
+        }
+
+        return hash;
+}
+
+/**
+ * compute the hash of every input the output of an entry depends upon
+ *
+ * \param ir The intermediate representation.
+ * \param irentry The entry to hash.
+ * \param hash The hash of the inputs common to all entries.
+ * \return the hash of the entry inputs
+ */
+static uint64_t
+entry_hash(struct ir *ir, struct ir_entry *irentry, uint64_t hash)
+{
+        struct ir_entry *inherite;
+        struct genbind_node *init_node;
+        struct genbind_node *param_node;
+        int idx;
+
+        /* the IDL for the entry and the binding class */
+        hash = genb_hash(hash, &irentry->idl_hash, sizeof(irentry->idl_hash));
+        hash = genbind_node_hash(irentry->class, hash);
+
+        /* whether anything inherits from the entry, which pruning alters */
+        hash = genb_hash(hash, &irentry->refcount, sizeof(irentry->refcount));
+
+        /* the parent name and initialiser signature */
+        inherite = ir_inherit_entry(ir, irentry);
+        if (inherite != NULL) {
+                hash = genb_hash(hash,
+                                 inherite->name,
+                                 strlen(inherite->name) + 1);
+
+                init_node = genbind_node_find_method(inherite->class,
+                                                     NULL,
+                                                     GENBIND_METHOD_TYPE_INIT);
+                param_node = genbind_node_find_type(
+                        genbind_node_getnode(init_node),
+                        NULL,
+                        GENBIND_NODE_TYPE_PARAMETER);
+                while (param_node != NULL) {
+                        hash = genbind_node_hash(param_node, hash);
+
+                        param_node = genbind_node_find_type(
+                                genbind_node_getnode(init_node),
+                                param_node,
+                                GENBIND_NODE_TYPE_PARAMETER);
+                }
+        }
+
+        /* the primary global creates every interface object */
+        if ((irentry->type == IR_ENTRY_TYPE_INTERFACE) &&
+            (irentry->u.interface.primary_global)) {
+                for (idx = 0; idx < ir->entryc; idx++) {
+                        struct ir_entry *entry;
+
+                        entry = ir->entries + idx;
+                        if ((entry->type == IR_ENTRY_TYPE_INTERFACE) &&
+                            (!entry->u.interface.noobject)) {
+                                hash = genb_hash(hash,
+                                                 entry->name,
+                                                 strlen(entry->name) + 1);
+                        }
+                }
+        }
+
+        return hash;
+}
+
+/**
+ * determine which outputs have changed since the previous run
+ *
+ * Each entry is hashed and compared with the hash recorded in the
+ * manifest in the output directory. Entries whose inputs are unchanged
+ * and whose output still exists are not generated again. When the
+ * entries are output in shards each shard is hashed from the entries
+ * it holds instead.
+ *
+ * \param ctx The output context.
+ * \param manifest The manifest to record the output hashes in.
+ * \return 0 on success else -1
+ */
+static int check_entries(struct output_ctx *ctx, struct manifest *manifest)
+{
+        struct ir *ir = ctx->ir;
+        struct manifest *prev;
+        struct output_shard *shard;
+        uint64_t common;
+        uint64_t hash;
+        int unchanged = 0;
+        int outputc = 0;
+        unsigned int shardidx;
+        int idx;
+
+        prev = manifest_new();
+        if ((prev == NULL) || (manifest_read(prev, MANIFEST_FILENAME) != 0)) {
+                manifest_free(prev);
+                return -1;
+        }
+
+        common = binding_hash(ir);
+
         for (idx = 0; idx < ir->entryc; idx++) {
                 struct ir_entry *irentry;
 
                 irentry = ir->entries + idx;
 
-                /* compute class name */
-                irentry->class_name = gen_idl2c_name(irentry->name);
+                /* interfaces marked no output have nothing to record */
+                if (((irentry->type == IR_ENTRY_TYPE_INTERFACE) &&
+                     (irentry->u.interface.noobject)) ||
+                    (irentry->filename == NULL)) {
+                        continue;
+                }
+
+                irentry->hash = entry_hash(ir, irentry, common);
 
-                if (irentry->class_name != NULL) {
-                        int ifacenamelen;
+                /* the shards are recorded instead of their entries */
+                if (ctx->shardc > 0) {
+                        continue;
+                }
+                outputc++;
 
-                        /* generate source filename */
-                        ifacenamelen = strlen(irentry->class_name) + 4;
-                        irentry->filename = malloc(ifacenamelen);
-                        snprintf(irentry->filename,
-                                 ifacenamelen,
-                                 "%s.c",
-                                 irentry->class_name);
+                if ((manifest_find(prev, irentry->filename, &hash) == 0) &&
+                    (hash == irentry->hash) &&
+                    genb_fexists(irentry->filename)) {
+                        irentry->unchanged = true;
+                        unchanged++;
+                }
+
+                if (manifest_add(manifest,
+                                 irentry->filename,
+                                 irentry->hash) != 0) {
+                        manifest_free(prev);
+                        return -1;
                 }
         }
 
-        res = output_interfaces_dictionaries(ir);
-        if (res != 0) {
-                goto output_err;
+        for (shardidx = 0; shardidx < ctx->shardc; shardidx++) {
+                shard = ctx->shardv + shardidx;
+                outputc++;
+
+                shard->hash = common;
+                for (idx = 0; idx < ir->entryc; idx++) {
+                        struct ir_entry *irentry;
+
+                        irentry = ir->entries + idx;
+                        if (irentry->shard != (int)shardidx) {
+                                continue;
+                        }
+                        shard->hash = genb_hash(shard->hash,
+                                                &irentry->hash,
+                                                sizeof(irentry->hash));
+                        shard->hash = genb_hash(shard->hash,
+                                                &irentry->local_init,
+                                                sizeof(irentry->local_init));
+                }
+
+                if ((manifest_find(prev, shard->filename, &hash) == 0) &&
+                    (hash == shard->hash) &&
+                    genb_fexists(shard->filename)) {
+                        shard->unchanged = true;
+                        unchanged++;
+                }
+
+                if (manifest_add(manifest,
+                                 shard->filename,
+                                 shard->hash) != 0) {
+                        manifest_free(prev);
+                        return -1;
+                }
         }
 
-        /* generate private header */
-        res = output_private_header(ir);
-        if (res != 0) {
-                goto output_err;
+        manifest_free(prev);
+
+        if (options->verbose) {
+                printf("%d of %d outputs unchanged\n", unchanged, outputc);
         }
 
-        /* generate prototype header */
-        res = output_prototype_header(ir);
-        if (res != 0) {
-                goto output_err;
+        return 0;
+}
+
+int duk_libdom_output(struct ir *ir)
+{
+        struct output_ctx ctx;
+        struct manifest *manifest;
+        unsigned int jobc;
+        int idx;
+        int res = 0;
+
+        /* process ir entries for output */
+        for (idx = 0; idx < ir->entryc; idx++) {
+                prepare_entry(ir->entries + idx);
         }
 
-        /* generate binding header */
-        res = output_binding_header(ir);
-        if (res != 0) {
-                goto output_err;
+        ctx.ir = ir;
+        ctx.shardc = 0;
+        ctx.shardv = NULL;
+        ctx.sizev = NULL;
+        if (options->shards > 0) {
+                res = assign_shards(&ctx);
         }
 
-        /* generate binding source */
-        res = output_binding_src(ir);
-        if (res != 0) {
-                goto output_err;
+        manifest = manifest_new();
+        if ((res != 0) || (manifest == NULL)) {
+                free_shards(&ctx);
+                return -1;
         }
 
-        /* generate makefile fragment */
-        res = output_makefile(ir);
+        if (ctx.shardc > 0) {
+                jobc = ctx.shardc;
+        } else {
+                jobc = ir->entryc;
+        }
+        if (options->classheaders) {
+                jobc += ir->entryc;
+        }
+        jobc += OUTPUT_BINDING_FILE_COUNT + 1;
+
+        res = check_entries(&ctx, manifest);
+        if (res == 0) {
+                res = threadpool_run(options->jobs, jobc, output_job, &ctx);
+        }
+
+        /* only record the hashes once all the output is written */
+        if (res == 0) {
+                res = manifest_write(manifest, MANIFEST_FILENAME);
+        }
 
-output_err:
+        manifest_free(manifest);
+        free_shards(&ctx);
 
         return res;
 }
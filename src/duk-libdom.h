@@ -27,6 +27,28 @@ int output_interface(struct ir *ir, struct ir_entry *interfacee);
  */
 int output_dictionary(struct ir *ir, struct ir_entry *dictionarye);
 
+/**
+ * generate the implementation of an interface into an output.
+ *
+ * \param outc The output context.
+ * \param ir The intermediate representation of the binding tree.
+ * \param interfacee The interface entry to output within the ir.
+ * \param standalone The output is the only one in its file so the tool
+ *                   and binding sections are generated around it.
+ */
+int output_interface_section(struct opctx *outc, struct ir *ir, struct ir_entry *interfacee, bool standalone);
+
+/**
+ * generate the implementation of a dictionary into an output.
+ *
+ * \param outc The output context.
+ * \param ir The intermediate representation of the binding tree.
+ * \param dictionarye The dictionary entry to output within the ir.
+ * \param standalone The output is the only one in its file so the tool
+ *                   and binding sections are generated around it.
+ */
+int output_dictionary_section(struct opctx *outc, struct ir *ir, struct ir_entry *dictionarye, bool standalone);
+
 /**
  * generate a declaration to implement a dictionary using duk and libdom.
  */
@@ -43,10 +65,33 @@ int output_dictionary_declaration(struct opctx *outc, struct ir_entry *dictionar
 int output_tool_preface(struct opctx *outc);
 
 /**
- * generate preface block for nsgenbind
+ * generate prologue block for nsgenbind
+ *
+ * When each class has its own headers only the binding header is
+ * included and output_tool_class_include() must be used for each
+ * class in the file.
  */
 int output_tool_prologue(struct opctx *outc);
 
+/**
+ * generate the include of a file in the output directory
+ *
+ * \param outc The output context.
+ * \param fname The leaf name of the file to include.
+ */
+int output_tool_include(struct opctx *outc, const char *fname);
+
+/**
+ * generate the include of the headers for a class
+ *
+ * Nothing is generated unless each class has its own headers.
+ *
+ * \param outc The output context.
+ * \param entry The interface or dictionary entry of the class.
+ * \return 0 on success else -1
+ */
+int output_tool_class_include(struct opctx *outc, struct ir_entry *entry);
+
 /**
  * output character data of node of given type.
  *
@@ -0,0 +1,165 @@
+/* string keyed hash table implementation
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hashtable.h"
+
+/** initial number of slots, must be a power of two */
+#define HASHTABLE_INITIAL_SIZE 64
+
+struct hashtable_entry {
+        const char *key;
+        void *value;
+        uint32_t hash;
+};
+
+struct hashtable {
+        unsigned int size; /**< number of slots */
+        unsigned int count; /**< number of occupied slots */
+        struct hashtable_entry *entries;
+};
+
+/**
+ * FNV-1a hash of a string
+ */
+static uint32_t hashtable_hash(const char *key)
+{
+        uint32_t hash = 2166136261U;
+
+        while (*key != 0) {
+                hash ^= (uint8_t)*key++;
+                hash *= 16777619U;
+        }
+        return hash;
+}
+
+/**
+ * find the slot for a key
+ *
+ * \return the slot holding the key or the empty slot where it belongs
+ */
+static struct hashtable_entry *
+hashtable_slot(struct hashtable_entry *entries,
+               unsigned int size,
+               const char *key,
+               uint32_t hash)
+{
+        unsigned int idx;
+
+        idx = hash & (size - 1);
+        while (entries[idx].key != NULL) {
+                if ((entries[idx].hash == hash) &&
+                    (strcmp(entries[idx].key, key) == 0)) {
+                        break;
+                }
+                idx = (idx + 1) & (size - 1);
+        }
+        return &entries[idx];
+}
+
+static int hashtable_grow(struct hashtable *ht)
+{
+        struct hashtable_entry *entries;
+        struct hashtable_entry *slot;
+        unsigned int size;
+        unsigned int idx;
+
+        size = ht->size * 2;
+        entries = calloc(size, sizeof(struct hashtable_entry));
+        if (entries == NULL) {
+                return -1;
+        }
+
+        for (idx = 0; idx < ht->size; idx++) {
+                if (ht->entries[idx].key != NULL) {
+                        slot = hashtable_slot(entries,
+                                              size,
+                                              ht->entries[idx].key,
+                                              ht->entries[idx].hash);
+                        *slot = ht->entries[idx];
+                }
+        }
+
+        free(ht->entries);
+        ht->entries = entries;
+        ht->size = size;
+
+        return 0;
+}
+
+/* exported interface documented in hashtable.h */
+struct hashtable *hashtable_new(void)
+{
+        struct hashtable *ht;
+
+        ht = malloc(sizeof(struct hashtable));
+        if (ht == NULL) {
+                return NULL;
+        }
+
+        ht->entries = calloc(HASHTABLE_INITIAL_SIZE,
+                             sizeof(struct hashtable_entry));
+        if (ht->entries == NULL) {
+                free(ht);
+                return NULL;
+        }
+        ht->size = HASHTABLE_INITIAL_SIZE;
+        ht->count = 0;
+
+        return ht;
+}
+
+/* exported interface documented in hashtable.h */
+void hashtable_free(struct hashtable *ht)
+{
+        if (ht != NULL) {
+                free(ht->entries);
+                free(ht);
+        }
+}
+
+/* exported interface documented in hashtable.h */
+int hashtable_insert(struct hashtable *ht, const char *key, void *value)
+{
+        struct hashtable_entry *slot;
+        uint32_t hash;
+
+        /* keep the load factor below three quarters */
+        if (((ht->count + 1) * 4) > (ht->size * 3)) {
+                if (hashtable_grow(ht) != 0) {
+                        return -1;
+                }
+        }
+
+        hash = hashtable_hash(key);
+        slot = hashtable_slot(ht->entries, ht->size, key, hash);
+        if (slot->key == NULL) {
+                slot->key = key;
+                slot->hash = hash;
+                ht->count++;
+        }
+        slot->value = value;
+
+        return 0;
+}
+
+/* exported interface documented in hashtable.h */
+void *hashtable_find(struct hashtable *ht, const char *key)
+{
+        struct hashtable_entry *slot;
+
+        if (ht == NULL) {
+                return NULL;
+        }
+
+        slot = hashtable_slot(ht->entries, ht->size, key, hashtable_hash(key));
+
+        return slot->value;
+}
@@ -0,0 +1,49 @@
+/* string keyed hash table
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ */
+
+#ifndef nsgenbind_hashtable_h
+#define nsgenbind_hashtable_h
+
+struct hashtable;
+
+/**
+ * create a new empty hash table
+ *
+ * \return new hash table or NULL on memory exhaustion
+ */
+struct hashtable *hashtable_new(void);
+
+/**
+ * free a hash table
+ *
+ * The keys and values are not owned by the table and are not freed.
+ */
+void hashtable_free(struct hashtable *ht);
+
+/**
+ * insert a value into a hash table
+ *
+ * The key is not copied and must remain valid for the lifetime of the
+ * table. If the key is already present its value is replaced.
+ *
+ * \param ht The hash table to insert into.
+ * \param key The string key.
+ * \param value The value to associate with the key.
+ * \return 0 on success or -1 on memory exhaustion
+ */
+int hashtable_insert(struct hashtable *ht, const char *key, void *value);
+
+/**
+ * find a value in a hash table
+ *
+ * \param ht The hash table to search.
+ * \param key The string key.
+ * \return the value associated with the key or NULL if not present
+ */
+void *hashtable_find(struct hashtable *ht, const char *key);
+
+#endif
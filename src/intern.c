@@ -0,0 +1,59 @@
+/* identifier interning implementation
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arena.h"
+#include "hashtable.h"
+#include "intern.h"
+
+/**
+ * arena holding the interned strings
+ */
+static struct arena *intern_arena;
+
+/**
+ * symbol table mapping string content to the canonical copy
+ */
+static struct hashtable *intern_table;
+
+/* exported interface documented in intern.h */
+char *intern_string(const char *s)
+{
+        char *res;
+
+        if (intern_table == NULL) {
+                intern_arena = arena_new();
+                intern_table = hashtable_new();
+                if ((intern_arena == NULL) || (intern_table == NULL)) {
+                        fprintf(stderr, "Error: out of memory\n");
+                        exit(EXIT_FAILURE);
+                }
+        }
+
+        res = hashtable_find(intern_table, s);
+        if (res == NULL) {
+                res = arena_strdup(intern_arena, s);
+                if ((res == NULL) ||
+                    (hashtable_insert(intern_table, res, res) != 0)) {
+                        fprintf(stderr, "Error: out of memory\n");
+                        exit(EXIT_FAILURE);
+                }
+        }
+
+        return res;
+}
+
+/* exported interface documented in intern.h */
+void intern_free(void)
+{
+        hashtable_free(intern_table);
+        intern_table = NULL;
+        arena_free(intern_arena);
+        intern_arena = NULL;
+}
@@ -0,0 +1,30 @@
+/* identifier interning
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ */
+
+#ifndef nsgenbind_intern_h
+#define nsgenbind_intern_h
+
+/**
+ * intern a string in the symbol table
+ *
+ * Every distinct string is stored once in a symbol table shared by the
+ * binding and Web IDL ASTs so interned strings may be compared for
+ * equality by pointer alone. The table is not locked so it must only be
+ * used from one thread, the Web IDL text is interned as each file is
+ * merged rather than while the files are parsed concurrently.
+ *
+ * \param s The string to intern.
+ * \return The canonical copy of the string which must not be modified.
+ */
+char *intern_string(const char *s);
+
+/**
+ * release the symbol table and every interned string
+ */
+void intern_free(void);
+
+#endif
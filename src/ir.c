@@ -15,9 +15,13 @@
 
 #include "options.h"
 #include "utils.h"
+#include "intern.h"
+#include "hashtable.h"
 #include "nsgenbind-ast.h"
 #include "webidl-ast.h"
 #include "ir.h"
+#include "memstats.h"
+#include "depfile.h"
 
 /** count the number of nodes of a given type on an interface */
 static int
@@ -47,82 +51,214 @@ enumerate_interface_type(struct webidl_node *interface_node,
 
 /* find index of inherited node if it is one of those listed in the
  * binding also maintain refcounts
+ *
+ * names are interned so each entry is found by name through a hash
+ * table of the first entry with each name.
  */
-static void
+static int
 compute_inherit_refcount(struct ir_entry *entries, int entryc)
 {
+        struct hashtable *names;
+        struct ir_entry *parent;
         int idx;
-        int inf;
+
+        names = hashtable_new();
+        if (names == NULL) {
+                return -1;
+        }
+
+        for (idx = 0; idx < entryc; idx++ ) {
+                entries[idx].refcount = 0;
+                if ((entries[idx].name != NULL) &&
+                    (hashtable_find(names, entries[idx].name) == NULL) &&
+                    (hashtable_insert(names,
+                                      entries[idx].name,
+                                      &entries[idx]) != 0)) {
+                        hashtable_free(names);
+                        return -1;
+                }
+        }
 
         for (idx = 0; idx < entryc; idx++ ) {
                 entries[idx].inherit_idx = -1;
-                for (inf = 0; inf < entryc; inf++ ) {
-                        /* cannot inherit from self and name must match */
-                        if ((inf != idx) &&
-                            (entries[idx].inherit_name != NULL ) &&
-                            (strcmp(entries[idx].inherit_name,
-                                    entries[inf].name) == 0)) {
-                                entries[idx].inherit_idx = inf;
-                                entries[inf].refcount++;
-                                break;
-                        }
+                if (entries[idx].inherit_name == NULL) {
+                        continue;
+                }
+
+                parent = hashtable_find(names, entries[idx].inherit_name);
+                if (parent == NULL) {
+                        WARN(WARNING_WEBIDL,
+                             "%s inherits from %s which is not defined",
+                             entries[idx].name,
+                             entries[idx].inherit_name);
+                        continue;
+                }
+
+                /* inheriting from self is left as a cycle to report */
+                entries[idx].inherit_idx = parent - entries;
+                parent->refcount++;
+        }
+
+        hashtable_free(names);
+
+        return 0;
+}
+
+/**
+ * add an entry index to a min heap
+ */
+static void entry_heap_push(int *heap, int *heapc, int inf)
+{
+        int pos = (*heapc)++;
+
+        while ((pos > 0) && (heap[(pos - 1) / 2] > inf)) {
+                heap[pos] = heap[(pos - 1) / 2];
+                pos = (pos - 1) / 2;
+        }
+        heap[pos] = inf;
+}
+
+/**
+ * remove the smallest entry index from a min heap
+ */
+static int entry_heap_pop(int *heap, int *heapc)
+{
+        int res = heap[0];
+        int last = heap[--(*heapc)];
+        int pos = 0;
+        int child;
+
+        while ((child = (pos * 2) + 1) < *heapc) {
+                if (((child + 1) < *heapc) && (heap[child + 1] < heap[child])) {
+                        child++;
+                }
+                if (last <= heap[child]) {
+                        break;
+                }
+                heap[pos] = heap[child];
+                pos = child;
+        }
+        heap[pos] = last;
+
+        return res;
+}
+
+/**
+ * report the entries whose inheritance forms a cycle
+ *
+ * \param srcinf The entries.
+ * \param pending The number of unsorted entries inheriting from each entry.
+ */
+static void
+entry_report_cycles(struct ir_entry *srcinf, int infc, int *pending)
+{
+        int inf;
+        int cur;
+        int steps;
+
+        for (inf = 0; inf < infc; inf++) {
+                if (pending[inf] == 0) {
+                        continue;
+                }
+
+                /* only entries which inherit from themselves are in a
+                 * cycle, the others are ancestors of one
+                 */
+                cur = srcinf[inf].inherit_idx;
+                steps = 0;
+                while ((cur != -1) && (cur != inf) && (steps++ < infc)) {
+                        cur = srcinf[cur].inherit_idx;
+                }
+                if (cur == inf) {
+                        fprintf(stderr,
+                                "Error: %s is part of an inheritance cycle through %s\n",
+                                srcinf[inf].name,
+                                srcinf[inf].inherit_name);
                 }
         }
 }
 
 /** Topoligical sort based on the refcount
  *
- * do not need to consider loops as constructed graph is a acyclic
+ * Kahn's algorithm with the entries nothing inherits from as the
+ * initial set.
  *
  * alloc a second copy of the map
  * repeat until all entries copied:
- *   walk source mapping until first entry with zero refcount
+ *   take the first entry with zero refcount from a heap
  *   put the entry  at the end of the output map
- *   reduce refcount on inherit index if !=-1
- *   remove entry from source map
+ *   reduce refcount on inherit index if !=-1 adding it to the heap
+ *     once it reaches zero
+ *
+ * Any entries left over are in or inherited by an inheritance cycle.
  */
 static struct ir_entry *
 entry_topoligical_sort(struct ir_entry *srcinf, int infc)
 {
         struct ir_entry *dstinf;
+        int *pending; /* refcount of each source entry */
+        int *heap; /* source entries with zero refcount */
+        int heapc = 0;
+        int *dstidx; /* output index of each source entry */
         int idx;
         int inf;
 
         dstinf = calloc(infc, sizeof(struct ir_entry));
-        if (dstinf == NULL) {
+        pending = malloc(infc * sizeof(int));
+        heap = malloc(infc * sizeof(int));
+        dstidx = malloc(infc * sizeof(int));
+        if ((dstinf == NULL) ||
+            (pending == NULL) ||
+            (heap == NULL) ||
+            (dstidx == NULL)) {
+                free(dstinf);
+                free(pending);
+                free(heap);
+                free(dstidx);
                 return NULL;
         }
 
-        for (idx = infc - 1; idx >= 0; idx--) {
-                /* walk source map until first valid entry with zero refcount */
-                inf = 0;
-                while ((inf < infc) &&
-                       ((srcinf[inf].name == NULL) ||
-                        (srcinf[inf].refcount > 0))) {
-                        inf++;
+        for (inf = 0; inf < infc; inf++) {
+                pending[inf] = srcinf[inf].refcount;
+                if (pending[inf] == 0) {
+                        entry_heap_push(heap, &heapc, inf);
                 }
-                if (inf == infc) {
+        }
+
+        for (idx = infc - 1; idx >= 0; idx--) {
+                if (heapc == 0) {
+                        entry_report_cycles(srcinf, infc, pending);
                         free(dstinf);
-                        return NULL;
+                        dstinf = NULL;
+                        break;
                 }
+                inf = entry_heap_pop(heap, &heapc);
 
                 /* copy entry to the end of the output map */
-                dstinf[idx].name = srcinf[inf].name;
-                dstinf[idx].node = srcinf[inf].node;
-                dstinf[idx].inherit_name = srcinf[inf].inherit_name;
-                dstinf[idx].class = srcinf[inf].class;
-                dstinf[idx].type = srcinf[inf].type;
-                dstinf[idx].u = srcinf[inf].u;
+                dstinf[idx] = srcinf[inf];
+                dstidx[inf] = idx;
 
                 /* reduce refcount on inherit index if !=-1 */
-                if (srcinf[inf].inherit_idx != -1) {
-                        srcinf[srcinf[inf].inherit_idx].refcount--;
+                if ((srcinf[inf].inherit_idx != -1) &&
+                    (--pending[srcinf[inf].inherit_idx] == 0)) {
+                        entry_heap_push(heap, &heapc, srcinf[inf].inherit_idx);
                 }
+        }
 
-                /* remove entry from source map */
-                srcinf[inf].name = NULL;
+        /* inheritance indexes refer to the sorted map */
+        if (dstinf != NULL) {
+                for (idx = 0; idx < infc; idx++) {
+                        if (dstinf[idx].inherit_idx != -1) {
+                                dstinf[idx].inherit_idx =
+                                        dstidx[dstinf[idx].inherit_idx];
+                        }
+                }
         }
 
+        free(pending);
+        free(heap);
+        free(dstidx);
+
         return dstinf;
 }
 
@@ -137,21 +273,214 @@ find_operation_name(struct ir_operation_entry *operationv,
         for (opc = 0; opc < operationc; opc++) {
                 cure = operationv + opc;
 
+                /* names are interned so pointers are equivalent */
                 if (cure->name == name) {
-                        /* check pointers for equivalence */
                         return cure;
-                } else {
-                        if ((cure->name != NULL) &&
-                            (name != NULL) &&
-                            (strcmp(cure->name, name) == 0)) {
-                                return cure;
-                        }
                 }
         }
 
         return NULL;
 }
 
+/**
+ * Create IR entry for a type
+ */
+static int
+type_map_new(struct webidl_node *node,
+             int *typec_out,
+             struct ir_type_entry **typev_out)
+{
+        int typec;
+        struct webidl_node *type_node;
+        struct ir_type_entry *typev;
+        struct ir_type_entry *cure;
+
+        typec = webidl_node_enumerate_type(
+                            webidl_node_getnode(node),
+                            WEBIDL_NODE_TYPE_TYPE);
+        if (typec == 0) {
+                *typec_out = 0;
+                *typev_out = NULL;
+                return 0;
+        }
+
+        typev = calloc(typec, sizeof(*typev));
+        cure = typev;
+
+        type_node = webidl_node_find_type(webidl_node_getnode(node),
+                                          NULL,
+                                          WEBIDL_NODE_TYPE_TYPE);
+
+        while (type_node != NULL) {
+                enum webidl_type *base;
+                enum webidl_type_modifier *modifier;
+
+                /* type base */
+                base = (enum webidl_type *)webidl_node_getint(
+                        webidl_node_find_type(
+                                webidl_node_getnode(type_node),
+                                NULL,
+                                WEBIDL_NODE_TYPE_TYPE_BASE));
+                if (base != NULL) {
+                        cure->base = *base;
+                } else {
+                        cure->nobase = true;
+                }
+
+                /* type modifier */
+                modifier = (enum webidl_type_modifier *)webidl_node_getint(
+                        webidl_node_find_type(
+                                webidl_node_getnode(type_node),
+                                NULL,
+                                WEBIDL_NODE_TYPE_MODIFIER));
+                if (modifier != NULL) {
+                        cure->modifier = *modifier;
+                } else {
+                        cure->modifier = WEBIDL_TYPE_MODIFIER_NONE;
+                }
+
+                /* type nullability */
+                cure->nullable = (webidl_node_find_type(
+                        webidl_node_getnode(type_node),
+                        NULL,
+                        WEBIDL_NODE_TYPE_TYPE_NULLABLE) != NULL);
+
+                /* type name */
+                cure->name = webidl_node_gettext(
+                        webidl_node_find_type(
+                                webidl_node_getnode(type_node),
+                                NULL,
+                                WEBIDL_NODE_TYPE_IDENT));
+
+                /* next entry */
+                cure++;
+
+                type_node = webidl_node_find_type(
+                        webidl_node_getnode(node),
+                        type_node,
+                        WEBIDL_NODE_TYPE_TYPE);
+        }
+
+        *typec_out = typec;
+        *typev_out = typev;
+
+        return 0;
+}
+
+/** literal node types in order of preference for a constant value */
+static const enum webidl_node_type literal_types[] = {
+        WEBIDL_NODE_TYPE_LITERAL_INT,
+        WEBIDL_NODE_TYPE_LITERAL_BOOL,
+        WEBIDL_NODE_TYPE_LITERAL_FLOAT,
+        WEBIDL_NODE_TYPE_LITERAL_STRING,
+        WEBIDL_NODE_TYPE_LITERAL_NULL,
+};
+
+/**
+ * Create IR entry for a literal value
+ *
+ * \param lit_node The literal node or NULL if there is no value.
+ * \param lite The entry to fill.
+ */
+static void
+literal_map_new(struct webidl_node *lit_node, struct ir_literal_entry *lite)
+{
+        int *lit_int;
+        float *lit_flt;
+
+        lite->type = IR_LITERAL_NONE;
+        if (lit_node == NULL) {
+                return;
+        }
+
+        switch (webidl_node_gettype(lit_node)) {
+        case WEBIDL_NODE_TYPE_LITERAL_NULL:
+                lite->type = IR_LITERAL_NULL;
+                break;
+
+        case WEBIDL_NODE_TYPE_LITERAL_INT:
+                lit_int = webidl_node_getint(lit_node);
+                lite->type = IR_LITERAL_INT;
+                lite->number = *lit_int;
+                break;
+
+        case WEBIDL_NODE_TYPE_LITERAL_BOOL:
+                lit_int = webidl_node_getint(lit_node);
+                lite->type = IR_LITERAL_BOOL;
+                lite->number = *lit_int;
+                break;
+
+        case WEBIDL_NODE_TYPE_LITERAL_FLOAT:
+                lit_flt = webidl_node_getfloat(lit_node);
+                lite->type = IR_LITERAL_FLOAT;
+                lite->flt = *lit_flt;
+                break;
+
+        case WEBIDL_NODE_TYPE_LITERAL_STRING:
+                lite->type = IR_LITERAL_STRING;
+                lite->text = intern_string(webidl_node_gettext(lit_node));
+                break;
+
+        default:
+                break;
+        }
+}
+
+/**
+ * Create IR entry for the value of a constant
+ */
+static void
+constant_value_new(struct webidl_node *constant_node,
+                   struct ir_literal_entry *lite)
+{
+        struct webidl_node *lit_node = NULL;
+        unsigned int idx;
+
+        for (idx = 0;
+             (lit_node == NULL) &&
+                     (idx < (sizeof(literal_types) / sizeof(literal_types[0])));
+             idx++) {
+                lit_node = webidl_node_find_type(
+                        webidl_node_getnode(constant_node),
+                        NULL,
+                        literal_types[idx]);
+        }
+
+        literal_map_new(lit_node, lite);
+}
+
+/**
+ * Fill IR entry for an operation argument or dictionary member
+ */
+static void
+argument_entry_new(struct webidl_node *argument,
+                   struct ir_operation_argument_entry *cure)
+{
+        struct webidl_node *optional_node;
+
+        cure->name = webidl_node_gettext(
+                webidl_node_find_type(
+                        webidl_node_getnode(argument),
+                        NULL,
+                        WEBIDL_NODE_TYPE_IDENT));
+
+        cure->optionalc = webidl_node_enumerate_type(
+                webidl_node_getnode(argument),
+                WEBIDL_NODE_TYPE_OPTIONAL);
+
+        cure->elipsisc = webidl_node_enumerate_type(
+                webidl_node_getnode(argument),
+                WEBIDL_NODE_TYPE_ELLIPSIS);
+
+        type_map_new(argument, &cure->typec, &cure->typev);
+
+        /* the default value is the first node on the optional */
+        optional_node = webidl_node_find_type(webidl_node_getnode(argument),
+                                              NULL,
+                                              WEBIDL_NODE_TYPE_OPTIONAL);
+        literal_map_new(webidl_node_getnode(optional_node), &cure->defl);
+}
+
 static int
 argument_map_new(struct webidl_node *arg_list_node,
                  int *argumentc_out,
@@ -181,21 +510,7 @@ argument_map_new(struct webidl_node *arg_list_node,
 
         while (argument != NULL) {
 
-                cure->name = webidl_node_gettext(
-                                webidl_node_find_type(
-                                        webidl_node_getnode(argument),
-                                        NULL,
-                                        WEBIDL_NODE_TYPE_IDENT));
-
-                cure->node = argument;
-
-                cure->optionalc = webidl_node_enumerate_type(
-                        webidl_node_getnode(argument),
-                        WEBIDL_NODE_TYPE_OPTIONAL);
-
-                cure->elipsisc = webidl_node_enumerate_type(
-                        webidl_node_getnode(argument),
-                        WEBIDL_NODE_TYPE_ELLIPSIS);
+                argument_entry_new(argument, cure);
 
                 cure++;
 
@@ -211,6 +526,190 @@ argument_map_new(struct webidl_node *arg_list_node,
         return 0;
 }
 
+/**
+ * Fill IR entry for an extended attribute
+ *
+ * \return 0 on success or -1 if the extended attribute has no name
+ */
+static int
+extended_attribute_entry_new(struct webidl_node *ext_attr,
+                             struct ir_extended_attribute_entry *cure)
+{
+        struct webidl_node *elem;
+        struct webidl_node *op_node;
+        char *ident;
+
+        /* the first identifier is the name */
+        elem = webidl_node_find_type(webidl_node_getnode(ext_attr),
+                                     NULL,
+                                     WEBIDL_NODE_TYPE_IDENT);
+        ident = webidl_node_gettext(elem);
+        if (ident == NULL) {
+                return -1;
+        }
+        cure->name = intern_string(ident);
+
+        /* a value follows an equals */
+        elem = webidl_node_find_type(webidl_node_getnode(ext_attr),
+                                     elem,
+                                     WEBIDL_NODE_TYPE_IDENT);
+        ident = webidl_node_gettext(elem);
+        if ((ident != NULL) && (*ident == '=')) {
+                ident = webidl_node_gettext(
+                        webidl_node_find_type(webidl_node_getnode(ext_attr),
+                                              elem,
+                                              WEBIDL_NODE_TYPE_IDENT));
+                if (ident != NULL) {
+                        cure->value = intern_string(ident);
+                }
+        }
+
+        /* constructors are an operation with the name of a named
+         * constructor as its identifier
+         */
+        op_node = webidl_node_find_type(webidl_node_getnode(ext_attr),
+                                        NULL,
+                                        WEBIDL_NODE_TYPE_OPERATION);
+        if (op_node != NULL) {
+                ident = webidl_node_gettext(
+                        webidl_node_find_type(webidl_node_getnode(op_node),
+                                              NULL,
+                                              WEBIDL_NODE_TYPE_IDENT));
+                if (ident != NULL) {
+                        cure->value = intern_string(ident);
+                }
+
+                argument_map_new(webidl_node_find_type(
+                                         webidl_node_getnode(op_node),
+                                         NULL,
+                                         WEBIDL_NODE_TYPE_LIST),
+                                 &cure->argumentc,
+                                 &cure->argumentv);
+        }
+
+        return 0;
+}
+
+/**
+ * create the table of extended attributes on a node
+ *
+ * The extended attributes are parsed once so they may be looked up by
+ * interned name with ir_extended_attribute().
+ */
+static int
+extended_attribute_map_new(struct webidl_node *node,
+                           int *extattrc_out,
+                           struct ir_extended_attribute_entry **extattrv_out)
+{
+        int extattrc;
+        struct webidl_node *ext_attr;
+        struct ir_extended_attribute_entry *extattrv;
+        struct ir_extended_attribute_entry *cure;
+
+        extattrc = webidl_node_enumerate_type(
+                webidl_node_getnode(node),
+                WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE);
+        if (extattrc == 0) {
+                *extattrc_out = 0;
+                *extattrv_out = NULL;
+                return 0;
+        }
+
+        extattrv = calloc(extattrc, sizeof(*extattrv));
+        if (extattrv == NULL) {
+                return -1;
+        }
+        cure = extattrv;
+
+        ext_attr = webidl_node_find_type(webidl_node_getnode(node),
+                                         NULL,
+                                         WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE);
+        while (ext_attr != NULL) {
+                if (extended_attribute_entry_new(ext_attr, cure) == 0) {
+                        cure++;
+                }
+
+                ext_attr = webidl_node_find_type(
+                        webidl_node_getnode(node),
+                        ext_attr,
+                        WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE);
+        }
+
+        *extattrc_out = cure - extattrv;
+        *extattrv_out = extattrv;
+
+        return 0;
+}
+
+/**
+ * get the value of an extended attribute
+ *
+ * \return the interned value or NULL if the extended attribute is not
+ *         present or has no value
+ */
+static const char *
+extended_attribute_value(int extattrc,
+                         struct ir_extended_attribute_entry *extattrv,
+                         const char *name)
+{
+        struct ir_extended_attribute_entry *extattr;
+
+        extattr = ir_extended_attribute(extattrc,
+                                        extattrv,
+                                        intern_string(name));
+        if (extattr == NULL) {
+                return NULL;
+        }
+        return extattr->value;
+}
+
+/**
+ * release an array of arguments and their types
+ */
+static void
+ir_arguments_free(int argumentc, struct ir_operation_argument_entry *argumentv)
+{
+        int idx;
+
+        for (idx = 0; idx < argumentc; idx++) {
+                free(argumentv[idx].typev);
+        }
+        free(argumentv);
+}
+
+/**
+ * release an array of extended attributes and their arguments
+ */
+static void
+ir_extattrs_free(int extattrc, struct ir_extended_attribute_entry *extattrv)
+{
+        int idx;
+
+        for (idx = 0; idx < extattrc; idx++) {
+                ir_arguments_free(extattrv[idx].argumentc,
+                                  extattrv[idx].argumentv);
+        }
+        free(extattrv);
+}
+
+/**
+ * release an array of operation overloads
+ */
+static void
+ir_overloads_free(int overloadc, struct ir_operation_overload_entry *overloadv)
+{
+        int idx;
+
+        for (idx = 0; idx < overloadc; idx++) {
+                free(overloadv[idx].typev);
+                ir_arguments_free(overloadv[idx].argumentc,
+                                  overloadv[idx].argumentv);
+                ir_extattrs_free(overloadv[idx].extattrc,
+                                 overloadv[idx].extattrv);
+        }
+        free(overloadv);
+}
+
 /**
  * create a new overloaded parameter set on an operation
  *
@@ -243,9 +742,7 @@ overload_map_new(struct webidl_node *op_node,
         cure = memset(cure, 0, sizeof(*cure));
 
         /* return type */
-        cure->type = webidl_node_find_type(webidl_node_getnode(op_node),
-                                           NULL,
-                                           WEBIDL_NODE_TYPE_TYPE);
+        type_map_new(op_node, &cure->typec, &cure->typev);
 
         arg_list_node = webidl_node_find_type(webidl_node_getnode(op_node),
                                               NULL,
@@ -254,6 +751,13 @@ overload_map_new(struct webidl_node *op_node,
                 argument_map_new(arg_list_node,
                                  &cure->argumentc,
                                  &cure->argumentv);
+
+                /* the parser adds the extended attributes of each
+                 * overload to its argument list
+                 */
+                extended_attribute_map_new(arg_list_node,
+                                           &cure->extattrc,
+                                           &cure->extattrv);
         }
 
         for (argc = 0; argc < cure->argumentc; argc++) {
@@ -281,10 +785,12 @@ operation_map_new(struct webidl_node *interface,
         struct ir_operation_entry *cure; /* current entry */
         struct ir_operation_entry *operationv;
         int operationc;
+        int allocc;
 
         /* enumerate operationss including overloaded members */
         operationc = enumerate_interface_type(interface,
                                               WEBIDL_NODE_TYPE_OPERATION);
+        allocc = operationc;
 
         if (operationc < 1) {
                 /* no operations so empty map */
@@ -334,8 +840,6 @@ operation_map_new(struct webidl_node *interface,
 
                                 cure->name = operation_name;
 
-                                cure->node = op_node;
-
                                 cure->method = genbind_node_find_method_ident(
                                                class,
                                                NULL,
@@ -354,159 +858,33 @@ operation_map_new(struct webidl_node *interface,
                                 /* Overloaded entry does not advance the
                                  * current entry but does reduce list
                                  * length. Do not bother shortening allocation.
-                                 */
-                                operationc--;
-                        }
-
-                        /* move to next operation */
-                        op_node = webidl_node_find_type(
-                                webidl_node_getnode(list_node),
-                                op_node,
-                                WEBIDL_NODE_TYPE_OPERATION);
-                }
-
-                list_node = webidl_node_find_type(
-                        webidl_node_getnode(interface),
-                        list_node,
-                        WEBIDL_NODE_TYPE_LIST);
-        }
-
-        *operationc_out = operationc;
-        *operationv_out = operationv; /* resulting operations map */
-
-        return 0;
-}
-
-/**
- * get the value of an extended attribute key/value item
- */
-static char *
-get_extended_value(struct webidl_node *node, const char *key)
-{
-        char *ident;
-        struct webidl_node *ext_attr;
-        struct webidl_node *elem;
-
-        /* walk each extended attribute */
-        ext_attr = webidl_node_find_type(
-                webidl_node_getnode(node),
-                NULL,
-                WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE);
-        while (ext_attr != NULL) {
-
-                elem = webidl_node_find_type(
-                        webidl_node_getnode(ext_attr),
-                        NULL,
-                        WEBIDL_NODE_TYPE_IDENT);
-                ident = webidl_node_gettext(elem);
-
-                if ((ident != NULL) && (strcmp(ident, key) == 0)) {
-                        /* first identifier matches */
-
-                        elem = webidl_node_find_type(
-                                webidl_node_getnode(ext_attr),
-                                elem,
-                                WEBIDL_NODE_TYPE_IDENT);
-                        ident = webidl_node_gettext(elem);
-
-                        if ((ident != NULL) && (*ident == '=')) {
-                                return webidl_node_gettext(
-                                        webidl_node_find_type(
-                                                webidl_node_getnode(ext_attr),
-                                                elem,
-                                                WEBIDL_NODE_TYPE_IDENT));
-                        }
-                }
-
-                ext_attr = webidl_node_find_type(
-                        webidl_node_getnode(node),
-                        ext_attr,
-                        WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE);
-        }
-
-        return NULL;
-}
-
-
-/**
- * Create IR entry for a type
- */
-static int
-type_map_new(struct webidl_node *node,
-             int *typec_out,
-             struct ir_type_entry **typev_out)
-{
-        int typec;
-        struct webidl_node *type_node;
-        struct ir_type_entry *typev;
-        struct ir_type_entry *cure;
-
-        typec = webidl_node_enumerate_type(
-                            webidl_node_getnode(node),
-                            WEBIDL_NODE_TYPE_TYPE);
-        if (typec == 0) {
-                *typec_out = 0;
-                *typev_out = NULL;
-                return 0;
-        }
-
-        typev = calloc(typec, sizeof(*typev));
-        cure = typev;
-
-        type_node = webidl_node_find_type(webidl_node_getnode(node),
-                                          NULL,
-                                          WEBIDL_NODE_TYPE_TYPE);
-
-        while (type_node != NULL) {
-                enum webidl_type *base;
-                enum webidl_type_modifier *modifier;
-
-                /* type base */
-                base = (enum webidl_type *)webidl_node_getint(
-                        webidl_node_find_type(
-                                webidl_node_getnode(type_node),
-                                NULL,
-                                WEBIDL_NODE_TYPE_TYPE_BASE));
-                if (base != NULL) {
-                        cure->base = *base;
-                }
-
-                /* type modifier */
-                modifier = (enum webidl_type_modifier *)webidl_node_getint(
-                        webidl_node_find_type(
-                                webidl_node_getnode(type_node),
-                                NULL,
-                                WEBIDL_NODE_TYPE_MODIFIER));
-                if (modifier != NULL) {
-                        cure->modifier = *modifier;
-                } else {
-                        cure->modifier = WEBIDL_TYPE_MODIFIER_NONE;
-                }
-
-                /* type nullability */
-                cure->nullable = (webidl_node_find_type(
-                        webidl_node_getnode(type_node),
-                        NULL,
-                        WEBIDL_NODE_TYPE_TYPE_NULLABLE) != NULL);
-
-                /* type name */
-                cure->name = webidl_node_gettext(
-                        webidl_node_find_type(
-                                webidl_node_getnode(type_node),
-                                NULL,
-                                WEBIDL_NODE_TYPE_IDENT));
+                                 */
+                                operationc--;
+                        }
 
-                /* next entry */
-                cure++;
+                        /* move to next operation */
+                        op_node = webidl_node_find_type(
+                                webidl_node_getnode(list_node),
+                                op_node,
+                                WEBIDL_NODE_TYPE_OPERATION);
+                }
 
-                type_node = webidl_node_find_type(
-                        webidl_node_getnode(node),
-                        type_node,
-                        WEBIDL_NODE_TYPE_TYPE);
+                list_node = webidl_node_find_type(
+                        webidl_node_getnode(interface),
+                        list_node,
+                        WEBIDL_NODE_TYPE_LIST);
         }
 
-        *typec_out = typec;
-        *typev_out = typev;
+        /* an operation without an identifier matches the first unused
+         * entry so if none follows it is beyond the end of the map and
+         * its overloads are released
+         */
+        for (; cure < operationv + allocc; cure++) {
+                ir_overloads_free(cure->overloadc, cure->overloadv);
+        }
+
+        *operationc_out = operationc;
+        *operationv_out = operationv; /* resulting operations map */
 
         return 0;
 }
@@ -560,8 +938,6 @@ attribute_map_new(struct webidl_node *interface,
 
                         enum webidl_type_modifier *modifier;
 
-                        cure->node = at_node;
-
                         cure->name = webidl_node_gettext(
                                 webidl_node_find_type(
                                         webidl_node_getnode(at_node),
@@ -596,9 +972,15 @@ attribute_map_new(struct webidl_node *interface,
                                                      cure->name);
                         }
 
+                        extended_attribute_map_new(at_node,
+                                                   &cure->extattrc,
+                                                   &cure->extattrv);
+
                         /* check for putforwards extended attribute */
-                        cure->putforwards = get_extended_value(at_node,
-                                                               "PutForwards");
+                        cure->putforwards = extended_attribute_value(
+                                cure->extattrc,
+                                cure->extattrv,
+                                "PutForwards");
 
                         if ((cure->putforwards != NULL) &&
                             (cure->modifier != WEBIDL_TYPE_MODIFIER_READONLY)) {
@@ -608,8 +990,10 @@ attribute_map_new(struct webidl_node *interface,
                         }
 
                         /* check for treatnullas extended attribute */
-                        cure->treatnullas = get_extended_value(at_node,
-                                                               "TreatNullAs");
+                        cure->treatnullas = extended_attribute_value(
+                                cure->extattrc,
+                                cure->extattrv,
+                                "TreatNullAs");
 
                         /* move to next attribute */
                         cure++;
@@ -675,14 +1059,14 @@ constant_map_new(struct webidl_node *interface,
                         WEBIDL_NODE_TYPE_CONST);
 
                 while (constant_node != NULL) {
-                        cure->node = constant_node;
-
                         cure->name = webidl_node_gettext(
                                 webidl_node_find_type(
                                         webidl_node_getnode(constant_node),
                                         NULL,
                                         WEBIDL_NODE_TYPE_IDENT));
 
+                        constant_value_new(constant_node, &cure->value);
+
                         cure++;
 
                         /* move to next constant */
@@ -745,21 +1129,7 @@ member_map_new(struct webidl_node *dictionary,
                         WEBIDL_NODE_TYPE_ARGUMENT);
 
                 while (member_node != NULL) {
-                        cure->node = member_node;
-
-                        cure->name = webidl_node_gettext(
-                                webidl_node_find_type(
-                                        webidl_node_getnode(member_node),
-                                        NULL,
-                                        WEBIDL_NODE_TYPE_IDENT));
-
-                        cure->optionalc = webidl_node_enumerate_type(
-                                webidl_node_getnode(member_node),
-                                WEBIDL_NODE_TYPE_OPTIONAL);
-
-                        cure->elipsisc = webidl_node_enumerate_type(
-                                webidl_node_getnode(member_node),
-                                WEBIDL_NODE_TYPE_ELLIPSIS);
+                        argument_entry_new(member_node, cure);
 
                         cure++;
 
@@ -821,7 +1191,7 @@ entry_map_new(struct genbind_node *genbind,
         while (node != NULL) {
 
                 /* fill map entry */
-                cure->node = node;
+                cure->idl_hash = webidl_node_hash(node, GENB_HASH_INIT);
 
                 /* name of interface */
                 cure->name = webidl_node_gettext(
@@ -847,11 +1217,15 @@ entry_map_new(struct genbind_node *genbind,
                 /* identify this is an interface entry */
                 cure->type = IR_ENTRY_TYPE_INTERFACE;
 
+                extended_attribute_map_new(node,
+                                           &cure->extattrc,
+                                           &cure->extattrv);
+
                 /* is the interface marked as not generating an object */
-                if (webidl_node_find_type_ident(
-                            webidl_node_getnode(node),
-                            WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE,
-                            "NoInterfaceObject") != NULL) {
+                if (ir_extended_attribute(
+                            cure->extattrc,
+                            cure->extattrv,
+                            intern_string("NoInterfaceObject")) != NULL) {
                         /** \todo we should ensure inherit is unset as this
                          * cannot form part of an inheritance chain if it is
                          * not generating an output class
@@ -860,10 +1234,10 @@ entry_map_new(struct genbind_node *genbind,
                 }
 
                 /* is the interface marked as the primary global */
-                if (webidl_node_find_type_ident(
-                            webidl_node_getnode(node),
-                            WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE,
-                            "PrimaryGlobal") != NULL) {
+                if (ir_extended_attribute(
+                            cure->extattrc,
+                            cure->extattrv,
+                            intern_string("PrimaryGlobal")) != NULL) {
                         /** \todo we should ensure nothing inherits *from* this
                          * class or all hell will break loose having two
                          * primary globals.
@@ -902,7 +1276,7 @@ entry_map_new(struct genbind_node *genbind,
         while (node != NULL) {
 
                 /* fill map entry */
-                cure->node = node;
+                cure->idl_hash = webidl_node_hash(node, GENB_HASH_INIT);
 
                 /* name of interface */
                 cure->name = webidl_node_gettext(
@@ -928,6 +1302,10 @@ entry_map_new(struct genbind_node *genbind,
                 /* identify this is an interface entry */
                 cure->type = IR_ENTRY_TYPE_DICTIONARY;
 
+                extended_attribute_map_new(node,
+                                           &cure->extattrc,
+                                           &cure->extattrv);
+
                 /* enumerate and map the dictionary members */
                 member_map_new(node,
                                &cure->u.dictionary.memberc,
@@ -941,7 +1319,10 @@ entry_map_new(struct genbind_node *genbind,
         }
 
         /* compute inheritance and refcounts on map */
-        compute_inherit_refcount(entries, entryc);
+        if (compute_inherit_refcount(entries, entryc) != 0) {
+                free(entries);
+                return -1;
+        }
 
         /* sort entries to ensure correct ordering */
         sorted_entries = entry_topoligical_sort(entries, entryc);
@@ -950,9 +1331,6 @@ entry_map_new(struct genbind_node *genbind,
                 return -1;
         }
 
-        /* compute inheritance and refcounts on sorted map */
-        compute_inherit_refcount(sorted_entries, entryc);
-
         *interfacec_out = entryc;
         *interfacev_out = sorted_entries;
 
@@ -972,7 +1350,6 @@ int ir_new(struct genbind_node *genbind,
             return -1;
         }
 
-        map->webidl = webidl;
         map->binding_node = genbind_node_find_type(genbind, NULL,
                                                    GENBIND_NODE_TYPE_BINDING);
 
@@ -991,6 +1368,386 @@ int ir_new(struct genbind_node *genbind,
         return 0;
 }
 
+static void ir_interface_free(struct ir_interface_entry *interface)
+{
+        struct ir_attribute_entry *attributee;
+        int opidx;
+        int attridx;
+
+        for (opidx = 0; opidx < interface->operationc; opidx++) {
+                ir_overloads_free(interface->operationv[opidx].overloadc,
+                                  interface->operationv[opidx].overloadv);
+        }
+        free(interface->operationv);
+
+        attributee = interface->attributev;
+        for (attridx = 0; attridx < interface->attributec; attridx++) {
+                free(attributee->property_name);
+                free(attributee->typev);
+                ir_extattrs_free(attributee->extattrc, attributee->extattrv);
+                attributee++;
+        }
+        free(interface->attributev);
+
+        free(interface->constantv);
+}
+
+/**
+ * release everything an entry owns
+ *
+ * The text is interned and the binding nodes belong to the binding AST
+ * so neither is released.
+ */
+static void ir_entry_free(struct ir_entry *entry)
+{
+        free(entry->filename);
+        free(entry->class_name);
+        ir_extattrs_free(entry->extattrc, entry->extattrv);
+
+        switch (entry->type) {
+        case IR_ENTRY_TYPE_INTERFACE:
+                ir_interface_free(&entry->u.interface);
+                break;
+
+        case IR_ENTRY_TYPE_DICTIONARY:
+                ir_arguments_free(entry->u.dictionary.memberc,
+                                  entry->u.dictionary.memberv);
+                break;
+        }
+}
+
+/* exported interface documented in ir.h */
+void ir_free(struct ir *map)
+{
+        int idx;
+
+        if (map == NULL) {
+                return;
+        }
+
+        for (idx = 0; idx < map->entryc; idx++) {
+                ir_entry_free(&map->entries[idx]);
+        }
+        free(map->entries);
+        free(map);
+}
+
+/**
+ * state of pruning the map
+ */
+struct ir_prune_ctx {
+        struct ir *map;
+        struct hashtable *names; /**< entries by name */
+        bool *keepv; /**< entries which are reachable */
+        int *workv; /**< reachable entries yet to be followed */
+        int workc; /**< number of entries yet to be followed */
+};
+
+/**
+ * mark an entry as reachable
+ */
+static void prune_mark_entry(struct ir_prune_ctx *ctx, struct ir_entry *entry)
+{
+        int idx = entry - ctx->map->entries;
+
+        if (!ctx->keepv[idx]) {
+                ctx->keepv[idx] = true;
+                ctx->workv[ctx->workc++] = idx;
+        }
+}
+
+/**
+ * mark the entry named by each user type as reachable
+ */
+static void
+prune_mark_types(struct ir_prune_ctx *ctx,
+                 int typec,
+                 struct ir_type_entry *typev)
+{
+        struct ir_entry *entry;
+        int idx;
+
+        for (idx = 0; idx < typec; idx++) {
+                if (typev[idx].name != NULL) {
+                        entry = hashtable_find(ctx->names, typev[idx].name);
+                        if (entry != NULL) {
+                                prune_mark_entry(ctx, entry);
+                        }
+                }
+        }
+}
+
+static void
+prune_mark_arguments(struct ir_prune_ctx *ctx,
+                     int argumentc,
+                     struct ir_operation_argument_entry *argumentv)
+{
+        int idx;
+
+        for (idx = 0; idx < argumentc; idx++) {
+                prune_mark_types(ctx, argumentv[idx].typec, argumentv[idx].typev);
+        }
+}
+
+static void
+prune_mark_extattrs(struct ir_prune_ctx *ctx,
+                    int extattrc,
+                    struct ir_extended_attribute_entry *extattrv)
+{
+        int idx;
+
+        for (idx = 0; idx < extattrc; idx++) {
+                prune_mark_arguments(ctx,
+                                     extattrv[idx].argumentc,
+                                     extattrv[idx].argumentv);
+        }
+}
+
+/**
+ * mark everything an entry uses as reachable
+ *
+ * That is the entry it inherits from and the interfaces and
+ * dictionaries used as the type of its members.
+ */
+static void prune_mark_uses(struct ir_prune_ctx *ctx, struct ir_entry *entry)
+{
+        struct ir_interface_entry *interface;
+        struct ir_operation_entry *operatione;
+        struct ir_operation_overload_entry *overloade;
+        int opidx;
+        int ovidx;
+        int attridx;
+
+        if (entry->inherit_idx != -1) {
+                prune_mark_entry(ctx, &ctx->map->entries[entry->inherit_idx]);
+        }
+
+        prune_mark_extattrs(ctx, entry->extattrc, entry->extattrv);
+
+        switch (entry->type) {
+        case IR_ENTRY_TYPE_DICTIONARY:
+                prune_mark_arguments(ctx,
+                                     entry->u.dictionary.memberc,
+                                     entry->u.dictionary.memberv);
+                break;
+
+        case IR_ENTRY_TYPE_INTERFACE:
+                interface = &entry->u.interface;
+
+                operatione = interface->operationv;
+                for (opidx = 0; opidx < interface->operationc; opidx++) {
+                        overloade = operatione->overloadv;
+                        for (ovidx = 0;
+                             ovidx < operatione->overloadc;
+                             ovidx++) {
+                                prune_mark_types(ctx,
+                                                 overloade->typec,
+                                                 overloade->typev);
+                                prune_mark_arguments(ctx,
+                                                     overloade->argumentc,
+                                                     overloade->argumentv);
+                                prune_mark_extattrs(ctx,
+                                                    overloade->extattrc,
+                                                    overloade->extattrv);
+                                overloade++;
+                        }
+                        operatione++;
+                }
+
+                for (attridx = 0; attridx < interface->attributec; attridx++) {
+                        prune_mark_types(ctx,
+                                         interface->attributev[attridx].typec,
+                                         interface->attributev[attridx].typev);
+                }
+                break;
+        }
+}
+
+/**
+ * mark the entries listed in a file as reachable
+ *
+ * The file lists an interface or dictionary name on each line. Blank
+ * lines and text following a # are ignored.
+ */
+static int prune_mark_file(struct ir_prune_ctx *ctx, const char *filename)
+{
+        FILE *rootf;
+        char line[256];
+        char *name;
+        char *end;
+        struct ir_entry *entry;
+
+        rootf = fopen(filename, "r");
+        if (rootf == NULL) {
+                fprintf(stderr, "Error opening %s: %s\n",
+                        filename,
+                        strerror(errno));
+                return -1;
+        }
+        depfile_add(filename);
+
+        while (fgets(line, sizeof(line), rootf) != NULL) {
+                end = strchr(line, '#');
+                if (end != NULL) {
+                        *end = 0;
+                }
+
+                name = line;
+                while (isspace((unsigned char)*name)) {
+                        name++;
+                }
+                end = name + strlen(name);
+                while ((end > name) && isspace((unsigned char)*(end - 1))) {
+                        end--;
+                }
+                *end = 0;
+
+                if (*name == 0) {
+                        continue;
+                }
+
+                entry = hashtable_find(ctx->names, name);
+                if (entry == NULL) {
+                        WARN(WARNING_WEBIDL,
+                             "%s in %s is not an interface or dictionary",
+                             name,
+                             filename);
+                        continue;
+                }
+                prune_mark_entry(ctx, entry);
+        }
+
+        fclose(rootf);
+
+        return 0;
+}
+
+/* exported interface documented in ir.h */
+int ir_prune(struct ir *map, const char *rootfilename)
+{
+        struct ir_prune_ctx ctx;
+        struct ir_entry *entry;
+        int *dstidx; /* index of each entry once pruned */
+        int entryc = 0;
+        int idx;
+        int res = -1;
+
+        ctx.map = map;
+        ctx.workc = 0;
+        ctx.names = hashtable_new();
+        ctx.keepv = calloc(map->entryc + 1, sizeof(bool));
+        ctx.workv = malloc((map->entryc + 1) * sizeof(int));
+        dstidx = malloc((map->entryc + 1) * sizeof(int));
+        if ((ctx.names == NULL) ||
+            (ctx.keepv == NULL) ||
+            (ctx.workv == NULL) ||
+            (dstidx == NULL)) {
+                goto prune_error;
+        }
+
+        for (idx = 0; idx < map->entryc; idx++) {
+                entry = &map->entries[idx];
+                if ((hashtable_find(ctx.names, entry->name) == NULL) &&
+                    (hashtable_insert(ctx.names, entry->name, entry) != 0)) {
+                        goto prune_error;
+                }
+        }
+
+        /* the roots are the primary global, the interfaces with a
+         * class in the binding and any listed in the root file
+         */
+        for (idx = 0; idx < map->entryc; idx++) {
+                entry = &map->entries[idx];
+                if ((entry->class != NULL) ||
+                    ((entry->type == IR_ENTRY_TYPE_INTERFACE) &&
+                     (entry->u.interface.primary_global))) {
+                        prune_mark_entry(&ctx, entry);
+                }
+        }
+
+        if ((rootfilename != NULL) &&
+            (prune_mark_file(&ctx, rootfilename) != 0)) {
+                goto prune_error;
+        }
+
+        /* close over everything the reachable entries use */
+        while (ctx.workc > 0) {
+                ctx.workc--;
+                prune_mark_uses(&ctx, &map->entries[ctx.workv[ctx.workc]]);
+        }
+
+        /* remove the unreachable entries keeping the order, as every
+         * entry inherited from is kept the inheritance indexes remain
+         * valid once renumbered
+         */
+        for (idx = 0; idx < map->entryc; idx++) {
+                if (ctx.keepv[idx]) {
+                        dstidx[idx] = entryc;
+                        map->entries[entryc++] = map->entries[idx];
+                } else {
+                        ir_entry_free(&map->entries[idx]);
+                }
+        }
+
+        if (options->verbose) {
+                printf("Pruned %d of %d interfaces and dictionaries\n",
+                       map->entryc - entryc, map->entryc);
+        }
+        map->entryc = entryc;
+
+        for (idx = 0; idx < map->entryc; idx++) {
+                map->entries[idx].refcount = 0;
+        }
+        for (idx = 0; idx < map->entryc; idx++) {
+                entry = &map->entries[idx];
+                if (entry->inherit_idx != -1) {
+                        entry->inherit_idx = dstidx[entry->inherit_idx];
+                        map->entries[entry->inherit_idx].refcount++;
+                }
+        }
+
+        res = 0;
+
+prune_error:
+        hashtable_free(ctx.names);
+        free(ctx.keepv);
+        free(ctx.workv);
+        free(dstidx);
+
+        return res;
+}
+
+/**
+ * get a printable name of a type
+ */
+static const char *ir_type_name(struct ir_type_entry *typee)
+{
+        if (typee->name != NULL) {
+                return typee->name;
+        }
+        return webidl_type_to_str(typee->modifier, typee->base);
+}
+
+static void
+ir_dump_extended_attributes(FILE *dumpf,
+                            int extattrc,
+                            struct ir_extended_attribute_entry *extattrv)
+{
+        int idx;
+
+        for (idx = 0; idx < extattrc; idx++) {
+                fprintf(dumpf, "\textended attribute:%s", extattrv[idx].name);
+                if (extattrv[idx].value != NULL) {
+                        fprintf(dumpf, "=%s", extattrv[idx].value);
+                }
+                if (extattrv[idx].argumentc > 0) {
+                        fprintf(dumpf, " arguments:%d",
+                                extattrv[idx].argumentc);
+                }
+                fprintf(dumpf, "\n");
+        }
+}
+
 static int ir_dump_dictionary(FILE *dumpf, struct ir_entry *ecur)
 {
         if (ecur->u.dictionary.memberc > 0) {
@@ -1049,9 +1806,11 @@ static int ir_dump_interface(FILE *dumpf, struct ir_entry *ecur)
                                 fprintf(dumpf,
                                         "\t\t\toverload:%d\n", ovlc);
 
-                                fprintf(dumpf,
-                                        "\t\t\t\treturn type:%p\n",
-                                        ovle->type);
+                                if (ovle->typec > 0) {
+                                        fprintf(dumpf,
+                                                "\t\t\t\treturn type:%s\n",
+                                                ir_type_name(ovle->typev));
+                                }
 
                                 fprintf(dumpf,
                                         "\t\t\t\targuments:%d\n",
@@ -1153,6 +1912,9 @@ int ir_dump(struct ir *ir)
                 if (ecur->class != NULL) {
                         fprintf(dumpf, "\tclass:%p\n", ecur->class);
                 }
+                ir_dump_extended_attributes(dumpf,
+                                            ecur->extattrc,
+                                            ecur->extattrv);
 
                 switch (ecur->type) {
                 case IR_ENTRY_TYPE_INTERFACE:
@@ -1172,6 +1934,204 @@ int ir_dump(struct ir *ir)
         return 0;
 }
 
+/** kinds of array reported by ir_memstats() */
+enum ir_memstats_array {
+        IR_MEMSTATS_ENTRIES,
+        IR_MEMSTATS_OPERATIONV,
+        IR_MEMSTATS_OVERLOADV,
+        IR_MEMSTATS_ARGUMENTV,
+        IR_MEMSTATS_ATTRIBUTEV,
+        IR_MEMSTATS_TYPEV,
+        IR_MEMSTATS_CONSTANTV,
+        IR_MEMSTATS_MEMBERV,
+        IR_MEMSTATS_EXTATTRV,
+        IR_MEMSTATS_COUNT,
+};
+
+static const char *ir_memstats_name[IR_MEMSTATS_COUNT] = {
+        "entries",
+        "operationv",
+        "overloadv",
+        "argumentv",
+        "attributev",
+        "typev",
+        "constantv",
+        "memberv",
+        "extattrv",
+};
+
+/**
+ * account for an array of elements
+ */
+static void
+ir_memstats_array(struct memstats_entry *entry, int count, size_t size)
+{
+        if (count > 0) {
+                entry->count += count;
+                entry->bytes += count * size;
+        }
+}
+
+/**
+ * account for text owned by the intermediate representation
+ */
+static void ir_memstats_text(struct memstats_entry *entry, const char *text)
+{
+        if (text != NULL) {
+                entry->value_bytes += strlen(text) + 1;
+        }
+}
+
+/**
+ * account for an array of arguments and their types
+ */
+static void
+ir_memstats_arguments(struct memstats_entry *entries,
+                      enum ir_memstats_array array,
+                      int argumentc,
+                      struct ir_operation_argument_entry *argumentv)
+{
+        int argidx;
+
+        ir_memstats_array(&entries[array],
+                          argumentc,
+                          sizeof(struct ir_operation_argument_entry));
+        for (argidx = 0; argidx < argumentc; argidx++) {
+                ir_memstats_array(&entries[IR_MEMSTATS_TYPEV],
+                                  argumentv[argidx].typec,
+                                  sizeof(struct ir_type_entry));
+        }
+}
+
+/**
+ * account for an array of extended attributes and their arguments
+ */
+static void
+ir_memstats_extattrs(struct memstats_entry *entries,
+                     int extattrc,
+                     struct ir_extended_attribute_entry *extattrv)
+{
+        int idx;
+
+        ir_memstats_array(&entries[IR_MEMSTATS_EXTATTRV],
+                          extattrc,
+                          sizeof(struct ir_extended_attribute_entry));
+        for (idx = 0; idx < extattrc; idx++) {
+                ir_memstats_arguments(entries,
+                                      IR_MEMSTATS_ARGUMENTV,
+                                      extattrv[idx].argumentc,
+                                      extattrv[idx].argumentv);
+        }
+}
+
+static void
+ir_memstats_interface(struct memstats_entry *entries,
+                      struct ir_interface_entry *interface)
+{
+        struct ir_operation_entry *operatione;
+        struct ir_operation_overload_entry *overloade;
+        struct ir_attribute_entry *attributee;
+        int opidx;
+        int ovidx;
+        int attridx;
+
+        ir_memstats_array(&entries[IR_MEMSTATS_OPERATIONV],
+                          interface->operationc,
+                          sizeof(struct ir_operation_entry));
+        operatione = interface->operationv;
+        for (opidx = 0; opidx < interface->operationc; opidx++) {
+                ir_memstats_array(&entries[IR_MEMSTATS_OVERLOADV],
+                                  operatione->overloadc,
+                                  sizeof(struct ir_operation_overload_entry));
+                overloade = operatione->overloadv;
+                for (ovidx = 0; ovidx < operatione->overloadc; ovidx++) {
+                        ir_memstats_array(&entries[IR_MEMSTATS_TYPEV],
+                                          overloade->typec,
+                                          sizeof(struct ir_type_entry));
+                        ir_memstats_arguments(entries,
+                                              IR_MEMSTATS_ARGUMENTV,
+                                              overloade->argumentc,
+                                              overloade->argumentv);
+                        ir_memstats_extattrs(entries,
+                                             overloade->extattrc,
+                                             overloade->extattrv);
+                        overloade++;
+                }
+                operatione++;
+        }
+
+        ir_memstats_array(&entries[IR_MEMSTATS_ATTRIBUTEV],
+                          interface->attributec,
+                          sizeof(struct ir_attribute_entry));
+        attributee = interface->attributev;
+        for (attridx = 0; attridx < interface->attributec; attridx++) {
+                ir_memstats_text(&entries[IR_MEMSTATS_ATTRIBUTEV],
+                                 attributee->property_name);
+                ir_memstats_array(&entries[IR_MEMSTATS_TYPEV],
+                                  attributee->typec,
+                                  sizeof(struct ir_type_entry));
+                ir_memstats_extattrs(entries,
+                                     attributee->extattrc,
+                                     attributee->extattrv);
+                attributee++;
+        }
+
+        ir_memstats_array(&entries[IR_MEMSTATS_CONSTANTV],
+                          interface->constantc,
+                          sizeof(struct ir_constant_entry));
+}
+
+/* exported interface documented in ir.h */
+int ir_memstats(FILE *outf, struct ir *ir)
+{
+        struct memstats_entry entries[IR_MEMSTATS_COUNT];
+        struct memstats_entry total = { 0, 0, 0 };
+        struct ir_entry *ecur;
+        int eidx;
+        int idx;
+
+        memset(entries, 0, sizeof(entries));
+
+        ir_memstats_array(&entries[IR_MEMSTATS_ENTRIES],
+                          ir->entryc,
+                          sizeof(struct ir_entry));
+        entries[IR_MEMSTATS_ENTRIES].bytes += sizeof(struct ir);
+
+        ecur = ir->entries;
+        for (eidx = 0; eidx < ir->entryc; eidx++) {
+                ir_memstats_text(&entries[IR_MEMSTATS_ENTRIES],
+                                 ecur->filename);
+                ir_memstats_text(&entries[IR_MEMSTATS_ENTRIES],
+                                 ecur->class_name);
+                ir_memstats_extattrs(entries,
+                                     ecur->extattrc,
+                                     ecur->extattrv);
+
+                switch (ecur->type) {
+                case IR_ENTRY_TYPE_INTERFACE:
+                        ir_memstats_interface(entries, &ecur->u.interface);
+                        break;
+
+                case IR_ENTRY_TYPE_DICTIONARY:
+                        ir_memstats_arguments(entries,
+                                              IR_MEMSTATS_MEMBERV,
+                                              ecur->u.dictionary.memberc,
+                                              ecur->u.dictionary.memberv);
+                        break;
+                }
+                ecur++;
+        }
+
+        memstats_table_start(outf, "intermediate representation");
+        for (idx = 0; idx < IR_MEMSTATS_COUNT; idx++) {
+                memstats_table_row(outf, ir_memstats_name[idx], &entries[idx]);
+                memstats_entry_add(&total, &entries[idx]);
+        }
+        memstats_table_row(outf, "total", &total);
+
+        return 0;
+}
+
 int ir_dumpdot(struct ir *index)
 {
         FILE *dumpf;
@@ -1235,3 +2195,20 @@ ir_inherit_entry(struct ir *map,
         }
         return res;
 }
+
+/* exported interface documented in ir.h */
+struct ir_extended_attribute_entry *
+ir_extended_attribute(int extattrc,
+                      struct ir_extended_attribute_entry *extattrv,
+                      const char *name)
+{
+        int idx;
+
+        /* names are interned so compare pointers */
+        for (idx = 0; idx < extattrc; idx++) {
+                if (extattrv[idx].name == name) {
+                        return &extattrv[idx];
+                }
+        }
+        return NULL;
+}
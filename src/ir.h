@@ -9,9 +9,43 @@
 #ifndef nsgenbind_ir_h
 #define nsgenbind_ir_h
 
+#include <stdio.h>
+#include <stdint.h>
+
 struct genbind_node;
 struct webidl_node;
 
+/**
+ * ir entry for type of attributes or arguments.
+ */
+struct ir_type_entry {
+        enum webidl_type base; /**< base of the type (long, short, user etc.) */
+        enum webidl_type_modifier modifier; /**< modifier for the type */
+        bool nullable; /**< the type is nullable */
+        bool nobase; /**< the type has no base such as a promise */
+        const char *name; /**< name of type for user types */
+};
+
+/** kind of literal value */
+enum ir_literal_type {
+        IR_LITERAL_NONE = 0, /**< no value */
+        IR_LITERAL_NULL,
+        IR_LITERAL_INT,
+        IR_LITERAL_BOOL,
+        IR_LITERAL_FLOAT,
+        IR_LITERAL_STRING,
+};
+
+/**
+ * ir entry for a literal default or constant value
+ */
+struct ir_literal_entry {
+        enum ir_literal_type type; /**< kind of value */
+        int number; /**< value of an integer or boolean */
+        float flt; /**< value of a float */
+        const char *text; /**< value of a string */
+};
+
 /**
  * map entry for each argument of an overload on an operation
  */
@@ -21,48 +55,58 @@ struct ir_operation_argument_entry {
         int optionalc; /**< 1 if the argument is optional */
         int elipsisc; /**< 1 if the argument is an elipsis */
 
-        struct webidl_node *node;
+        int typec; /**< number of types for argument */
+        struct ir_type_entry *typev; /**< types of argument */
+
+        struct ir_literal_entry defl; /**< default of an optional argument */
+};
+
+/**
+ * ir entry for an extended attribute
+ *
+ * Extended attributes are a name optionally followed by a value and an
+ * argument list such as NoInterfaceObject, PutForwards=href,
+ * Constructor(DOMString type) or NamedConstructor=Image(long width).
+ */
+struct ir_extended_attribute_entry {
+        const char *name; /**< interned name */
+        const char *value; /**< interned value or NULL if there is none */
+
+        int argumentc; /**< number of arguments */
+        struct ir_operation_argument_entry *argumentv; /**< arguments */
 };
 
 /**
  * map entry for each overload of an operation.
  */
 struct ir_operation_overload_entry {
-        struct webidl_node *type; /**< The return type of this overload */
+        int typec; /**< number of return types of this overload */
+        struct ir_type_entry *typev; /**< return types of this overload */
 
         int optionalc; /**< Number of parameters that are optional */
         int elipsisc; /**< Number of elipsis parameters */
 
         int argumentc; /**< the number of parameters */
         struct ir_operation_argument_entry *argumentv;
+
+        int extattrc; /**< number of extended attributes */
+        struct ir_extended_attribute_entry *extattrv;
 };
 
 /** map entry for operations on an interface */
 struct ir_operation_entry {
         const char *name; /** operation name */
-        struct webidl_node *node; /**< AST operation node */
         struct genbind_node *method; /**< method from binding */
 
         int overloadc; /**< Number of overloads of this operation */
         struct ir_operation_overload_entry *overloadv;
 };
 
-/**
- * ir entry for type of attributes or arguments.
- */
-struct ir_type_entry {
-        enum webidl_type base; /**< base of the type (long, short, user etc.) */
-        enum webidl_type_modifier modifier; /**< modifier for the type */
-        bool nullable; /**< the type is nullable */
-        const char *name; /**< name of type for user types */
-};
-
 /**
  * ir entry for attributes on an interface
  */
 struct ir_attribute_entry {
         const char *name; /**< attribute name */
-        struct webidl_node *node; /**< AST attribute node */
 
         int typec; /**< number of types for attribute  */
         struct ir_type_entry *typev; /**< types on attribute */
@@ -71,6 +115,9 @@ struct ir_attribute_entry {
         const char *putforwards; /**< putforwards attribute */
         const char *treatnullas; /**< treatnullas attribute */
 
+        int extattrc; /**< number of extended attributes */
+        struct ir_extended_attribute_entry *extattrv;
+
         struct genbind_node *getter; /**< getter from binding */
         struct genbind_node *setter; /**< getter from binding */
 
@@ -86,7 +133,7 @@ struct ir_attribute_entry {
  */
 struct ir_constant_entry {
         const char *name; /** attribute name */
-        struct webidl_node *node; /**< AST constant node */
+        struct ir_literal_entry value; /**< value of the constant */
 };
 
 
@@ -126,10 +173,13 @@ enum ir_entry_type {
 /** top level entry info common to interfaces and dictionaries */
 struct ir_entry {
         const char *name; /** IDL name */
-        struct webidl_node *node; /**< AST node */
+        uint64_t idl_hash; /**< hash of the IDL definition */
         const char *inherit_name; /**< Name of interface inhertited from */
         struct genbind_node *class; /**< class from binding (if any) */
 
+        int extattrc; /**< number of extended attributes */
+        struct ir_extended_attribute_entry *extattrv;
+
         enum ir_entry_type type;
         union {
                 struct ir_dictionary_entry dictionary;
@@ -145,7 +195,8 @@ struct ir_entry {
 
         /* The variables are created and used by the output generation but
          * rather than have another allocation and pointer the data they are
-         * just inline here.
+         * just inline here. They are all computed before any output is
+         * generated so the entries are read only while output is produced.
          */
 
         char *filename; /**< filename used for output */
@@ -158,6 +209,12 @@ struct ir_entry {
         int class_init_argc; /**< The number of parameters on the class
                               * initializer.
                               */
+        bool local_init; /**< The initializer and finalizer are only called
+                          * from the file the entry is output in.
+                          */
+        int shard; /**< index of the shard the entry is output in or -1 */
+        uint64_t hash; /**< hash of every input the output depends upon */
+        bool unchanged; /**< the output is already up to date */
 };
 
 /** intermediate representation of WebIDL and binding data */
@@ -167,22 +224,59 @@ struct ir {
 
         /** The AST node of the binding information */
         struct genbind_node *binding_node;
-
-        /** Root AST node of the webIDL */
-        struct webidl_node *webidl;
 };
 
 /**
  * Create a new interface map
+ *
+ * Everything the output generation needs from the Web IDL is resolved
+ * into the map so the Web IDL AST is not referenced afterwards. All the
+ * text in the map is interned.
  */
 int ir_new(struct genbind_node *genbind,
                       struct webidl_node *webidl,
                       struct ir **map_out);
 
+/**
+ * release an interface map and everything it owns
+ *
+ * The binding nodes the map refers to are not released.
+ *
+ * \param map The map to release, may be NULL.
+ */
+void ir_free(struct ir *map);
+
+/**
+ * remove the entries the binding cannot use from the map
+ *
+ * The entries kept are those reachable from the primary global, the
+ * interfaces with a class in the binding and the interfaces and
+ * dictionaries listed in a file by following inheritance and the
+ * types of members.
+ *
+ * \param map The intermediate representation.
+ * \param rootfilename File listing additional interfaces and
+ *                     dictionaries to keep or NULL.
+ * \return 0 on success else -1
+ */
+int ir_prune(struct ir *map, const char *rootfilename);
+
 int ir_dump(struct ir *map);
 
 int ir_dumpdot(struct ir *map);
 
+/**
+ * write the memory held in the intermediate representation arrays
+ *
+ * Reports the entries and each kind of array hanging from them. The
+ * text computed by the output generator for each entry is included.
+ *
+ * \param outf The file to write the report to.
+ * \param map The intermediate representation.
+ * \return 0 on success
+ */
+int ir_memstats(FILE *outf, struct ir *map);
+
 /**
  * interface map parent entry
  *
@@ -190,4 +284,19 @@ int ir_dumpdot(struct ir *map);
  */
 struct ir_entry *ir_inherit_entry(struct ir *map, struct ir_entry *entry);
 
+/**
+ * find an extended attribute
+ *
+ * \param extattrc The number of extended attributes.
+ * \param extattrv The extended attributes of an entry, attribute or
+ *                 overload.
+ * \param name The interned name of the extended attribute.
+ * \return the first extended attribute with the name or NULL if there
+ *         is not one
+ */
+struct ir_extended_attribute_entry *
+ir_extended_attribute(int extattrc,
+                      struct ir_extended_attribute_entry *extattrv,
+                      const char *name);
+
 #endif
@@ -0,0 +1,180 @@
+/* output manifest implementation
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+
+#include "utils.h"
+#include "arena.h"
+#include "hashtable.h"
+#include "output.h"
+#include "manifest.h"
+
+struct manifest_entry {
+        struct manifest_entry *next;
+        const char *name;
+        uint64_t hash;
+};
+
+struct manifest {
+        struct arena *arena; /**< storage for entries and names */
+        struct hashtable *index; /**< entries indexed by name */
+        struct manifest_entry *entries; /**< entries in order added */
+        struct manifest_entry **tail; /**< link to append next entry to */
+};
+
+/* exported interface documented in manifest.h */
+struct manifest *manifest_new(void)
+{
+        struct manifest *manifest;
+
+        manifest = malloc(sizeof(struct manifest));
+        if (manifest == NULL) {
+                return NULL;
+        }
+
+        manifest->arena = arena_new();
+        manifest->index = hashtable_new();
+        if ((manifest->arena == NULL) || (manifest->index == NULL)) {
+                manifest_free(manifest);
+                return NULL;
+        }
+        manifest->entries = NULL;
+        manifest->tail = &manifest->entries;
+
+        return manifest;
+}
+
+/* exported interface documented in manifest.h */
+void manifest_free(struct manifest *manifest)
+{
+        if (manifest != NULL) {
+                hashtable_free(manifest->index);
+                arena_free(manifest->arena);
+                free(manifest);
+        }
+}
+
+/* exported interface documented in manifest.h */
+int manifest_add(struct manifest *manifest, const char *name, uint64_t hash)
+{
+        struct manifest_entry *entry;
+
+        entry = hashtable_find(manifest->index, name);
+        if (entry != NULL) {
+                entry->hash = hash;
+                return 0;
+        }
+
+        entry = arena_alloc(manifest->arena, sizeof(struct manifest_entry));
+        if (entry == NULL) {
+                return -1;
+        }
+        entry->name = arena_strdup(manifest->arena, name);
+        if (entry->name == NULL) {
+                return -1;
+        }
+        entry->hash = hash;
+
+        if (hashtable_insert(manifest->index, entry->name, entry) != 0) {
+                return -1;
+        }
+
+        *manifest->tail = entry;
+        manifest->tail = &entry->next;
+
+        return 0;
+}
+
+/* exported interface documented in manifest.h */
+int manifest_find(struct manifest *manifest, const char *name, uint64_t *hash_out)
+{
+        struct manifest_entry *entry;
+
+        entry = hashtable_find(manifest->index, name);
+        if (entry == NULL) {
+                return -1;
+        }
+        *hash_out = entry->hash;
+
+        return 0;
+}
+
+/* exported interface documented in manifest.h */
+int manifest_read(struct manifest *manifest, const char *fname)
+{
+        FILE *manf;
+        char *fpath;
+        char *line = NULL;
+        size_t linesize = 0;
+        int res = 0;
+
+        fpath = genb_fpath(fname);
+        manf = fopen(fpath, "r");
+        free(fpath);
+        if (manf == NULL) {
+                /* no previous manifest */
+                return 0;
+        }
+
+        while (getline(&line, &linesize, manf) != -1) {
+                uint64_t hash;
+                char *name;
+                size_t namelen;
+
+                if (line[0] == '#') {
+                        continue;
+                }
+
+                /* each line is a hex hash and a filename */
+                errno = 0;
+                hash = strtoull(line, &name, 16);
+                if ((errno != 0) || (name == line) || (*name != ' ')) {
+                        continue;
+                }
+                name++;
+
+                namelen = strcspn(name, "\r\n");
+                if (namelen == 0) {
+                        continue;
+                }
+                name[namelen] = 0;
+
+                if (manifest_add(manifest, name, hash) != 0) {
+                        res = -1;
+                        break;
+                }
+        }
+
+        free(line);
+        fclose(manf);
+
+        return res;
+}
+
+/* exported interface documented in manifest.h */
+int manifest_write(struct manifest *manifest, const char *fname)
+{
+        struct manifest_entry *entry;
+        struct opctx *manc;
+
+        if (output_open(fname, &manc) != 0) {
+                return -1;
+        }
+
+        outputs(manc, "# nsgenbind output manifest\n");
+
+        for (entry = manifest->entries; entry != NULL; entry = entry->next) {
+                outputf(manc, "%016" PRIx64 " %s\n", entry->hash, entry->name);
+        }
+
+        return output_close(manc);
+}
@@ -0,0 +1,74 @@
+/* output manifest
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ */
+
+#ifndef nsgenbind_manifest_h
+#define nsgenbind_manifest_h
+
+#include <stdint.h>
+
+/**
+ * set of output filenames each with the hash of the inputs it was
+ * generated from.
+ */
+struct manifest;
+
+/**
+ * create a new empty manifest
+ *
+ * \return new manifest or NULL on memory exhaustion
+ */
+struct manifest *manifest_new(void);
+
+/**
+ * free a manifest and all of its entries
+ */
+void manifest_free(struct manifest *manifest);
+
+/**
+ * read a manifest file from the output directory
+ *
+ * A missing file is not an error and leaves the manifest empty so every
+ * output is treated as changed.
+ *
+ * \param manifest The manifest to add the entries read to.
+ * \param fname The leaf filename of the manifest.
+ * \return 0 on success else -1
+ */
+int manifest_read(struct manifest *manifest, const char *fname);
+
+/**
+ * write a manifest file to the output directory
+ *
+ * Entries are written in the order they were added.
+ *
+ * \param manifest The manifest to write.
+ * \param fname The leaf filename of the manifest.
+ * \return 0 on success else -1
+ */
+int manifest_write(struct manifest *manifest, const char *fname);
+
+/**
+ * add an entry to a manifest
+ *
+ * \param manifest The manifest to add the entry to.
+ * \param name The output filename, it is copied.
+ * \param hash The hash of the inputs to the output.
+ * \return 0 on success or -1 on memory exhaustion
+ */
+int manifest_add(struct manifest *manifest, const char *name, uint64_t hash);
+
+/**
+ * find the hash recorded for an output
+ *
+ * \param manifest The manifest to search.
+ * \param name The output filename.
+ * \param hash_out Updated with the recorded hash if found.
+ * \return 0 if the output is in the manifest else -1
+ */
+int manifest_find(struct manifest *manifest, const char *name, uint64_t *hash_out);
+
+#endif
@@ -0,0 +1,229 @@
+/* memory use accounting implementation
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+
+#include "options.h"
+#include "memstats.h"
+
+/** initial number of slots, must be a power of two */
+#define MEMSTATS_SET_INITIAL_SIZE 1024
+
+struct memstats_set {
+        unsigned int size; /**< number of slots */
+        unsigned int count; /**< number of occupied slots */
+        const void **entries;
+};
+
+/** peak resident set size at the end of a phase */
+struct memstats_phase {
+        const char *name;
+        long maxrss; /**< peak resident set size in KiB */
+};
+
+static struct memstats_phase *memstats_phasev;
+static unsigned int memstats_phasec;
+
+/** peak resident set size at the end of the previous report */
+static long memstats_phase_base;
+
+/**
+ * hash of a pointer
+ */
+static uint32_t memstats_hash(const void *ptr)
+{
+        uintptr_t val = (uintptr_t)ptr;
+
+        /* low bits of allocations are mostly zero */
+        val ^= val >> 16;
+        return (uint32_t)val * 2654435761U;
+}
+
+/**
+ * find the slot for a pointer
+ *
+ * \return the slot holding the pointer or the empty slot where it belongs
+ */
+static const void **
+memstats_slot(const void **entries, unsigned int size, const void *ptr)
+{
+        unsigned int idx;
+
+        idx = memstats_hash(ptr) & (size - 1);
+        while ((entries[idx] != NULL) && (entries[idx] != ptr)) {
+                idx = (idx + 1) & (size - 1);
+        }
+        return &entries[idx];
+}
+
+static int memstats_set_grow(struct memstats_set *set)
+{
+        const void **entries;
+        unsigned int size;
+        unsigned int idx;
+
+        size = set->size * 2;
+        entries = calloc(size, sizeof(void *));
+        if (entries == NULL) {
+                return -1;
+        }
+
+        for (idx = 0; idx < set->size; idx++) {
+                if (set->entries[idx] != NULL) {
+                        *memstats_slot(entries, size, set->entries[idx]) =
+                                set->entries[idx];
+                }
+        }
+
+        free(set->entries);
+        set->entries = entries;
+        set->size = size;
+
+        return 0;
+}
+
+/* exported interface documented in memstats.h */
+struct memstats_set *memstats_set_new(void)
+{
+        struct memstats_set *set;
+
+        set = malloc(sizeof(struct memstats_set));
+        if (set == NULL) {
+                return NULL;
+        }
+
+        set->entries = calloc(MEMSTATS_SET_INITIAL_SIZE, sizeof(void *));
+        if (set->entries == NULL) {
+                free(set);
+                return NULL;
+        }
+        set->size = MEMSTATS_SET_INITIAL_SIZE;
+        set->count = 0;
+
+        return set;
+}
+
+/* exported interface documented in memstats.h */
+void memstats_set_free(struct memstats_set *set)
+{
+        if (set != NULL) {
+                free(set->entries);
+                free(set);
+        }
+}
+
+/* exported interface documented in memstats.h */
+bool memstats_set_add(struct memstats_set *set, const void *ptr)
+{
+        const void **slot;
+
+        if (ptr == NULL) {
+                return false;
+        }
+
+        /* keep the load factor below a half */
+        if (((set->count + 1) * 2) > set->size) {
+                if (memstats_set_grow(set) != 0) {
+                        /* counting twice is better than not at all */
+                        return true;
+                }
+        }
+
+        slot = memstats_slot(set->entries, set->size, ptr);
+        if (*slot != NULL) {
+                return false;
+        }
+        *slot = ptr;
+        set->count++;
+
+        return true;
+}
+
+/* exported interface documented in memstats.h */
+void memstats_phase(const char *phase)
+{
+        struct memstats_phase *phasev;
+        struct rusage usage;
+
+        if (!options->memstats) {
+                return;
+        }
+
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+                return;
+        }
+
+        phasev = realloc(memstats_phasev,
+                         (memstats_phasec + 1) * sizeof(struct memstats_phase));
+        if (phasev == NULL) {
+                return;
+        }
+        memstats_phasev = phasev;
+        memstats_phasev[memstats_phasec].name = phase;
+        memstats_phasev[memstats_phasec].maxrss = usage.ru_maxrss;
+        memstats_phasec++;
+}
+
+/* exported interface documented in memstats.h */
+void memstats_phase_report(FILE *outf)
+{
+        unsigned int idx;
+        long prev = memstats_phase_base;
+
+        fprintf(outf, "\npeak resident set size\n");
+        fprintf(outf, "  %-30s %12s %12s\n", "phase", "KiB", "growth KiB");
+        for (idx = 0; idx < memstats_phasec; idx++) {
+                fprintf(outf, "  %-30s %12ld %12ld\n",
+                        memstats_phasev[idx].name,
+                        memstats_phasev[idx].maxrss,
+                        memstats_phasev[idx].maxrss - prev);
+                prev = memstats_phasev[idx].maxrss;
+        }
+
+        memstats_phase_base = prev;
+        free(memstats_phasev);
+        memstats_phasev = NULL;
+        memstats_phasec = 0;
+}
+
+/* exported interface documented in memstats.h */
+void memstats_table_start(FILE *outf, const char *title)
+{
+        fprintf(outf, "\n%s\n", title);
+        fprintf(outf, "  %-28s %10s %12s %12s\n",
+                "type", "count", "bytes", "value bytes");
+}
+
+/* exported interface documented in memstats.h */
+void memstats_table_row(FILE *outf,
+                        const char *name,
+                        const struct memstats_entry *entry)
+{
+        if ((entry->count == 0) &&
+            (entry->bytes == 0) &&
+            (entry->value_bytes == 0)) {
+                return;
+        }
+        fprintf(outf, "  %-28s %10lu %12lu %12lu\n",
+                name,
+                entry->count,
+                (unsigned long)entry->bytes,
+                (unsigned long)entry->value_bytes);
+}
+
+/* exported interface documented in memstats.h */
+void memstats_entry_add(struct memstats_entry *total,
+                        const struct memstats_entry *entry)
+{
+        total->count += entry->count;
+        total->bytes += entry->bytes;
+        total->value_bytes += entry->value_bytes;
+}
@@ -0,0 +1,86 @@
+/* memory use accounting
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ */
+
+#ifndef nsgenbind_memstats_h
+#define nsgenbind_memstats_h
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/** accumulated use by one kind of object */
+struct memstats_entry {
+        unsigned long count; /**< number of objects */
+        size_t bytes; /**< bytes held by the objects themselves */
+        size_t value_bytes; /**< bytes held by their text and values */
+};
+
+/** set of objects already accounted for */
+struct memstats_set;
+
+/**
+ * create an empty set of accounted objects
+ *
+ * \return new set or NULL on memory exhaustion
+ */
+struct memstats_set *memstats_set_new(void);
+
+/**
+ * release a set of accounted objects
+ */
+void memstats_set_free(struct memstats_set *set);
+
+/**
+ * add an object to a set
+ *
+ * Used so objects reachable by more than one route, such as shared
+ * subtrees or interned text, are only counted once.
+ *
+ * \param set The set to add to.
+ * \param ptr The object.
+ * \return true if the object was not already in the set
+ */
+bool memstats_set_add(struct memstats_set *set, const void *ptr);
+
+/**
+ * record the peak resident set size at the end of a phase
+ *
+ * Nothing is recorded unless memory statistics were requested.
+ *
+ * \param phase The name of the phase which has finished.
+ */
+void memstats_phase(const char *phase);
+
+/**
+ * write the recorded phases and forget them
+ *
+ * The growth of the first phase is relative to the end of the previous
+ * report so each binding generated in a run is shown separately.
+ */
+void memstats_phase_report(FILE *outf);
+
+/**
+ * write the heading of a table of entries
+ */
+void memstats_table_start(FILE *outf, const char *title);
+
+/**
+ * write a row of a table of entries
+ *
+ * Rows for which nothing was counted are omitted.
+ */
+void memstats_table_row(FILE *outf,
+                        const char *name,
+                        const struct memstats_entry *entry);
+
+/**
+ * add an entry into a running total
+ */
+void memstats_entry_add(struct memstats_entry *total,
+                        const struct memstats_entry *entry);
+
+#endif
@@ -0,0 +1,440 @@
+/* index of AST node lists by node type implementation
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "nodeindex.h"
+
+/** initial number of slots, must be a power of two */
+#define NODEINDEX_INITIAL_SIZE 1024
+
+/** lists shorter than this are walked instead of indexed */
+#define NODEINDEX_MIN_LENGTH 16
+
+/** position of a node which is not in an indexed list */
+#define NODEINDEX_NO_POSITION ((unsigned int)-1)
+
+/**
+ * members of a list bucketed by type
+ *
+ * The position of a node is its distance from the tail of the list so
+ * lists which share a tail agree on the position of the shared nodes.
+ */
+struct nodeindex_list {
+        unsigned int nodec; /**< number of nodes in the list */
+        void **nodev; /**< nodes by position */
+        unsigned int typec; /**< one more than the largest node type */
+        unsigned int *typev; /**< start of each type in the positions */
+        unsigned int *posv; /**< positions grouped by type in order */
+};
+
+/**
+ * what is known about a node
+ */
+struct nodeindex_entry {
+        void *node;
+        unsigned int position; /**< position in the lists containing it */
+        unsigned int queries; /**< queries of the list the node heads */
+        struct nodeindex_list *list; /**< the list the node heads */
+};
+
+struct nodeindex {
+        nodeindex_next_t *next;
+        nodeindex_type_t *type;
+        bool built; /**< every list was indexed up front */
+        unsigned int size; /**< number of slots */
+        unsigned int count; /**< number of occupied slots */
+        struct nodeindex_entry *entries;
+};
+
+/**
+ * hash of a node pointer
+ */
+static uint32_t nodeindex_hash(const void *node)
+{
+        uintptr_t val = (uintptr_t)node;
+
+        /* low bits of allocations are mostly zero */
+        val ^= val >> 16;
+        return (uint32_t)val * 2654435761U;
+}
+
+/**
+ * find the slot for a node
+ *
+ * \return the slot holding the node or the empty slot where it belongs
+ */
+static struct nodeindex_entry *
+nodeindex_slot(struct nodeindex_entry *entries, unsigned int size, void *node)
+{
+        unsigned int idx;
+
+        idx = nodeindex_hash(node) & (size - 1);
+        while ((entries[idx].node != NULL) && (entries[idx].node != node)) {
+                idx = (idx + 1) & (size - 1);
+        }
+        return &entries[idx];
+}
+
+static int nodeindex_grow(struct nodeindex *index)
+{
+        struct nodeindex_entry *entries;
+        unsigned int size;
+        unsigned int idx;
+
+        size = index->size * 2;
+        entries = calloc(size, sizeof(struct nodeindex_entry));
+        if (entries == NULL) {
+                return -1;
+        }
+
+        for (idx = 0; idx < index->size; idx++) {
+                if (index->entries[idx].node != NULL) {
+                        *nodeindex_slot(entries,
+                                        size,
+                                        index->entries[idx].node) =
+                                index->entries[idx];
+                }
+        }
+
+        free(index->entries);
+        index->entries = entries;
+        index->size = size;
+
+        return 0;
+}
+
+/**
+ * get the entry for a node creating it if necessary
+ *
+ * \return the entry or NULL on memory exhaustion
+ */
+static struct nodeindex_entry *
+nodeindex_entry(struct nodeindex *index, void *node)
+{
+        struct nodeindex_entry *entry;
+
+        /* keep the load factor below a half */
+        if (((index->count + 1) * 2) > index->size) {
+                if (nodeindex_grow(index) != 0) {
+                        return NULL;
+                }
+        }
+
+        entry = nodeindex_slot(index->entries, index->size, node);
+        if (entry->node == NULL) {
+                entry->node = node;
+                entry->position = NODEINDEX_NO_POSITION;
+                index->count++;
+        }
+        return entry;
+}
+
+static void nodeindex_list_free(struct nodeindex_list *list)
+{
+        if (list != NULL) {
+                free(list->nodev);
+                free(list->typev);
+                free(list->posv);
+                free(list);
+        }
+}
+
+/**
+ * bucket the members of a list by type
+ *
+ * \return the indexed list or NULL on memory exhaustion
+ */
+static struct nodeindex_list *
+nodeindex_list_new(struct nodeindex *index, void *head)
+{
+        struct nodeindex_list *list;
+        struct nodeindex_entry *entry;
+        void *node;
+        unsigned int pos;
+        unsigned int type;
+
+        list = calloc(1, sizeof(struct nodeindex_list));
+        if (list == NULL) {
+                return NULL;
+        }
+
+        for (node = head; node != NULL; node = index->next(node)) {
+                type = index->type(node);
+                if (type >= list->typec) {
+                        list->typec = type + 1;
+                }
+                list->nodec++;
+        }
+
+        list->nodev = malloc(list->nodec * sizeof(void *));
+        list->typev = calloc(list->typec + 1, sizeof(unsigned int));
+        list->posv = malloc(list->nodec * sizeof(unsigned int));
+        if ((list->nodev == NULL) ||
+            (list->typev == NULL) ||
+            (list->posv == NULL)) {
+                nodeindex_list_free(list);
+                return NULL;
+        }
+
+        /* the head is furthest from the tail */
+        pos = list->nodec;
+        for (node = head; node != NULL; node = index->next(node)) {
+                pos--;
+                list->nodev[pos] = node;
+                list->typev[index->type(node) + 1]++;
+
+                entry = nodeindex_entry(index, node);
+                if (entry == NULL) {
+                        nodeindex_list_free(list);
+                        return NULL;
+                }
+                entry->position = pos;
+        }
+
+        /* start of each bucket */
+        for (type = 0; type < list->typec; type++) {
+                list->typev[type + 1] += list->typev[type];
+        }
+
+        /* fill the buckets in position order */
+        for (pos = 0; pos < list->nodec; pos++) {
+                type = index->type(list->nodev[pos]);
+                list->posv[list->typev[type]++] = pos;
+        }
+
+        /* filling advanced each start to the next bucket */
+        for (type = list->typec; type > 0; type--) {
+                list->typev[type] = list->typev[type - 1];
+        }
+        list->typev[0] = 0;
+
+        return list;
+}
+
+/**
+ * check if a list is too short to be worth indexing
+ *
+ * Walking a short list is cheaper than looking it up in the index.
+ */
+static bool nodeindex_short(struct nodeindex *index, void *head)
+{
+        unsigned int length = 0;
+
+        while ((head != NULL) && (length < NODEINDEX_MIN_LENGTH)) {
+                head = index->next(head);
+                length++;
+        }
+        return length < NODEINDEX_MIN_LENGTH;
+}
+
+/**
+ * get the indexed list headed by a node
+ *
+ * A built index is only looked up. Otherwise lists are only indexed on
+ * their second query as many are only queried once and walking them is
+ * cheaper than indexing them.
+ *
+ * \return the list or NULL if it must be walked
+ */
+static struct nodeindex_list *
+nodeindex_list(struct nodeindex *index, void *head)
+{
+        struct nodeindex_entry *entry;
+        struct nodeindex_list *list;
+
+        if (index->built) {
+                return nodeindex_slot(index->entries, index->size, head)->list;
+        }
+
+        entry = nodeindex_entry(index, head);
+        if (entry == NULL) {
+                return NULL;
+        }
+
+        if ((entry->list == NULL) && (entry->queries++ > 0)) {
+                list = nodeindex_list_new(index, head);
+                /* building may have moved the entry */
+                entry = nodeindex_slot(index->entries, index->size, head);
+                entry->list = list;
+        }
+
+        return entry->list;
+}
+
+/* exported interface documented in nodeindex.h */
+struct nodeindex *nodeindex_new(nodeindex_next_t *next, nodeindex_type_t *type)
+{
+        struct nodeindex *index;
+
+        index = malloc(sizeof(struct nodeindex));
+        if (index == NULL) {
+                return NULL;
+        }
+
+        index->entries = calloc(NODEINDEX_INITIAL_SIZE,
+                                sizeof(struct nodeindex_entry));
+        if (index->entries == NULL) {
+                free(index);
+                return NULL;
+        }
+        index->size = NODEINDEX_INITIAL_SIZE;
+        index->count = 0;
+        index->next = next;
+        index->type = type;
+        index->built = false;
+
+        return index;
+}
+
+/* exported interface documented in nodeindex.h */
+void nodeindex_free(struct nodeindex *index)
+{
+        unsigned int idx;
+
+        if (index == NULL) {
+                return;
+        }
+
+        for (idx = 0; idx < index->size; idx++) {
+                nodeindex_list_free(index->entries[idx].list);
+        }
+        free(index->entries);
+        free(index);
+}
+
+/**
+ * index a list and the lists held by its nodes
+ */
+static int
+nodeindex_build_list(struct nodeindex *index,
+                     void *head,
+                     nodeindex_child_t *child)
+{
+        struct nodeindex_entry *entry;
+        struct nodeindex_list *list;
+        void *node;
+        void *sub;
+
+        for (node = head; node != NULL; node = index->next(node)) {
+                sub = child(node);
+                if ((sub != NULL) &&
+                    (nodeindex_build_list(index, sub, child) != 0)) {
+                        return -1;
+                }
+        }
+
+        if (nodeindex_short(index, head)) {
+                return 0;
+        }
+
+        entry = nodeindex_entry(index, head);
+        if (entry == NULL) {
+                return -1;
+        }
+
+        if (entry->list == NULL) {
+                list = nodeindex_list_new(index, head);
+                if (list == NULL) {
+                        return -1;
+                }
+                /* building may have moved the entry */
+                entry = nodeindex_slot(index->entries, index->size, head);
+                entry->list = list;
+        }
+
+        return 0;
+}
+
+/* exported interface documented in nodeindex.h */
+int nodeindex_build(struct nodeindex *index,
+                    void *root,
+                    nodeindex_child_t *child)
+{
+        if (nodeindex_build_list(index, root, child) != 0) {
+                return -1;
+        }
+        index->built = true;
+
+        return 0;
+}
+
+/* exported interface documented in nodeindex.h */
+int nodeindex_find(struct nodeindex *index,
+                   void *head,
+                   void *prev,
+                   unsigned int type,
+                   void **found_out)
+{
+        struct nodeindex_list *list;
+        struct nodeindex_entry *entry;
+        unsigned int start = 0;
+        unsigned int lo;
+        unsigned int hi;
+        unsigned int mid;
+
+        if (nodeindex_short(index, head)) {
+                return -1;
+        }
+
+        list = nodeindex_list(index, head);
+        if (list == NULL) {
+                return -1;
+        }
+
+        /* a previous node not in the list does not limit the search */
+        if (prev != NULL) {
+                entry = nodeindex_slot(index->entries, index->size, prev);
+                if ((entry->node != NULL) &&
+                    (entry->position < list->nodec) &&
+                    (list->nodev[entry->position] == prev)) {
+                        start = entry->position + 1;
+                }
+        }
+
+        *found_out = NULL;
+        if (type < list->typec) {
+                /* first position of the type at or after the start */
+                lo = list->typev[type];
+                hi = list->typev[type + 1];
+                while (lo < hi) {
+                        mid = lo + ((hi - lo) / 2);
+                        if (list->posv[mid] < start) {
+                                lo = mid + 1;
+                        } else {
+                                hi = mid;
+                        }
+                }
+                if (lo < list->typev[type + 1]) {
+                        *found_out = list->nodev[list->posv[lo]];
+                }
+        }
+
+        return 0;
+}
+
+/* exported interface documented in nodeindex.h */
+int nodeindex_count(struct nodeindex *index, void *head, unsigned int type)
+{
+        struct nodeindex_list *list;
+        int count = 0;
+
+        if (nodeindex_short(index, head)) {
+                return -1;
+        }
+
+        list = nodeindex_list(index, head);
+        if (list == NULL) {
+                count = -1;
+        } else if (type < list->typec) {
+                count = list->typev[type + 1] - list->typev[type];
+        }
+
+        return count;
+}
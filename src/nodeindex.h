@@ -0,0 +1,98 @@
+/* index of AST node lists by node type
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ */
+
+#ifndef nsgenbind_nodeindex_h
+#define nsgenbind_nodeindex_h
+
+/**
+ * index of the node lists of an AST
+ *
+ * Both ASTs hold the children of a node as a singly linked list of
+ * siblings and every typed query walks the whole list. The index
+ * buckets the members of a long list by node type the second time the
+ * list is queried so repeated queries only visit the matching nodes.
+ *
+ * A list is identified by its first node and the index is only valid
+ * while no list it has seen is altered.
+ */
+struct nodeindex;
+
+/** get the next sibling of a node */
+typedef void *(nodeindex_next_t)(void *node);
+
+/** get the type of a node */
+typedef unsigned int (nodeindex_type_t)(void *node);
+
+/** get the first node of the list a node holds or NULL if it holds none */
+typedef void *(nodeindex_child_t)(void *node);
+
+/**
+ * create an empty node list index
+ *
+ * \param next Callback to get the next sibling of a node.
+ * \param type Callback to get the type of a node.
+ * \return new index or NULL on memory exhaustion
+ */
+struct nodeindex *nodeindex_new(nodeindex_next_t *next, nodeindex_type_t *type);
+
+/**
+ * release a node list index
+ *
+ * The nodes themselves are not owned by the index.
+ */
+void nodeindex_free(struct nodeindex *index);
+
+/**
+ * index every list of a tree
+ *
+ * Once built the index is never altered by a query so it may be used
+ * by several threads at once. Lists which are not part of the tree are
+ * walked instead of indexed. An index which is not built indexes lists
+ * as they are queried and must only be used by a single thread.
+ *
+ * \param index The index to build.
+ * \param root The first node of the top level list of the tree.
+ * \param child Callback to get the list held by a node.
+ * \return 0 on success or -1 on memory exhaustion
+ */
+int nodeindex_build(struct nodeindex *index,
+                    void *root,
+                    nodeindex_child_t *child);
+
+/**
+ * find the next node of a type in a list
+ *
+ * The same node is found as by walking the list from its tail towards
+ * its head and returning the first node of the type which is nearer
+ * the head than the previous node.
+ *
+ * \param index The index to use.
+ * \param head The first node of the list.
+ * \param prev The previously found node or NULL to find the first.
+ * \param type The type of node to find.
+ * \param found_out The found node or NULL if there are no more.
+ * \return 0 on success or -1 if the list is short or not indexed yet
+ *         and must be walked instead
+ */
+int nodeindex_find(struct nodeindex *index,
+                   void *head,
+                   void *prev,
+                   unsigned int type,
+                   void **found_out);
+
+/**
+ * count the nodes of a type in a list
+ *
+ * \param index The index to use.
+ * \param head The first node of the list.
+ * \param type The type of node to count.
+ * \return the number of nodes of the type or -1 if the list is short
+ *         or not indexed yet and must be walked instead
+ */
+int nodeindex_count(struct nodeindex *index, void *head, unsigned int type);
+
+#endif
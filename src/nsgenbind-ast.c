@@ -11,25 +11,76 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <errno.h>
 #include <string.h>
 #include <stdarg.h>
 
 #include "utils.h"
+#include "arena.h"
+#include "depfile.h"
+#include "hashtable.h"
 #include "nsgenbind-ast.h"
 #include "options.h"
+#include "memstats.h"
+#include "nodeindex.h"
 
 /**
  * standard IO handle for parse trace logging.
  */
 static FILE *genbind_parsetracef;
 
+/**
+ * arena owning the nodes and text of the AST being parsed or used.
+ *
+ * Each parse creates its own arena so the AST of one binding may be
+ * released in a single operation before the next is parsed.
+ */
+static struct arena *genbind_arena;
+
+/**
+ * index of the node lists by type once the binding has been parsed.
+ */
+static struct nodeindex *genbind_nodeindex;
+
+/** number of method types */
+#define GENBIND_METHOD_TYPE_COUNT (GENBIND_METHOD_TYPE_POSTFACE + 1)
+
+/**
+ * methods of a class by type and identifier.
+ */
+struct genbind_class_symbols {
+        struct genbind_node *class;
+        struct genbind_node *method[GENBIND_METHOD_TYPE_COUNT]; /**< first
+                                                          * method of each
+                                                          * type
+                                                          */
+        struct hashtable *ident[GENBIND_METHOD_TYPE_COUNT]; /**< methods of
+                                                      * each type by
+                                                      * identifier
+                                                      */
+};
+
+/**
+ * symbols of the parsed binding so classes and methods are found
+ * without walking their lists.
+ */
+static struct genbind_symbols {
+        struct genbind_node *root; /**< binding AST the symbols are for */
+        struct hashtable *classes; /**< classes by identifier */
+        int classc; /**< number of classes */
+        struct genbind_class_symbols *classv; /**< classes in address order */
+} genbind_symbols;
+
 /* parser and lexer interface */
 extern int nsgenbind_debug;
-extern int nsgenbind__flex_debug;
-extern void nsgenbind_restart(FILE*);
-extern int nsgenbind_parse(char *filename, struct genbind_node **genbind_ast);
+extern int nsgenbind_scanner_new(FILE *infile, void **scanner_out);
+extern void nsgenbind_scanner_free(void *scanner);
+extern void nsgenbind_set_debug(int debug, void *scanner);
+extern int nsgenbind_parse(void *scanner,
+                           char *filename,
+                           struct genbind_node **genbind_ast);
 
 /* terminal nodes have a value only */
 struct genbind_node {
@@ -101,15 +152,260 @@ genbind_node_add(struct genbind_node *node, struct genbind_node *list)
 	return node;
 }
 
+/**
+ * allocate zeroed memory owned by the AST
+ */
+static void *genbind_alloc(size_t size)
+{
+        void *res;
+
+        res = arena_alloc(genbind_arena, size);
+        if (res == NULL) {
+                fprintf(stderr, "Error: out of memory\n");
+                exit(EXIT_FAILURE);
+        }
+        return res;
+}
+
+/* exported interface documented in nsgenbind-ast.h */
+char *genbind_strndup(const char *s, size_t n)
+{
+        char *res;
+
+        res = arena_strndup(genbind_arena, s, n);
+        if (res == NULL) {
+                fprintf(stderr, "Error: out of memory\n");
+                exit(EXIT_FAILURE);
+        }
+        return res;
+}
+
+/* exported interface documented in nsgenbind-ast.h */
+char *genbind_strdup(const char *s)
+{
+        return genbind_strndup(s, strlen(s));
+}
+
+/**
+ * compare two classes by address
+ */
+static int genbind_class_symbols_cmp(const void *a, const void *b)
+{
+        uintptr_t aclass;
+        uintptr_t bclass;
+
+        aclass = (uintptr_t)((const struct genbind_class_symbols *)a)->class;
+        bclass = (uintptr_t)((const struct genbind_class_symbols *)b)->class;
+
+        if (aclass < bclass) {
+                return -1;
+        }
+        return (aclass > bclass) ? 1 : 0;
+}
+
+/**
+ * get the symbols of a class
+ *
+ * \return the symbols or NULL if the class is not in the index
+ */
+static struct genbind_class_symbols *
+genbind_class_symbols(struct genbind_node *class)
+{
+        struct genbind_class_symbols key;
+
+        if ((class == NULL) || (genbind_symbols.classv == NULL)) {
+                return NULL;
+        }
+
+        key.class = class;
+        return bsearch(&key,
+                       genbind_symbols.classv,
+                       genbind_symbols.classc,
+                       sizeof(struct genbind_class_symbols),
+                       genbind_class_symbols_cmp);
+}
+
+/**
+ * index the methods of a class
+ *
+ * The first method in search order of each type and identifier is
+ * the one recorded as that is the one a search finds.
+ */
+static int genbind_class_symbols_new(struct genbind_class_symbols *cls)
+{
+        struct genbind_node *method;
+        int *type;
+        char *ident;
+
+        method = genbind_node_find_type(genbind_node_getnode(cls->class),
+                                        NULL,
+                                        GENBIND_NODE_TYPE_METHOD);
+        while (method != NULL) {
+                type = genbind_node_getint(
+                        genbind_node_find_type(
+                                genbind_node_getnode(method),
+                                NULL,
+                                GENBIND_NODE_TYPE_METHOD_TYPE));
+                if ((type == NULL) ||
+                    (*type < 0) ||
+                    (*type >= GENBIND_METHOD_TYPE_COUNT)) {
+                        return -1;
+                }
+
+                if (cls->method[*type] == NULL) {
+                        cls->method[*type] = method;
+                }
+
+                ident = genbind_node_gettext(
+                        genbind_node_find_type(
+                                genbind_node_getnode(method),
+                                NULL,
+                                GENBIND_NODE_TYPE_IDENT));
+                if (ident != NULL) {
+                        if (cls->ident[*type] == NULL) {
+                                cls->ident[*type] = hashtable_new();
+                                if (cls->ident[*type] == NULL) {
+                                        return -1;
+                                }
+                        }
+                        if ((hashtable_find(cls->ident[*type],
+                                            ident) == NULL) &&
+                            (hashtable_insert(cls->ident[*type],
+                                              ident,
+                                              method) != 0)) {
+                                return -1;
+                        }
+                }
+
+                method = genbind_node_find_type(
+                        genbind_node_getnode(cls->class),
+                        method,
+                        GENBIND_NODE_TYPE_METHOD);
+        }
+
+        return 0;
+}
+
+/**
+ * build the symbol index of a parsed binding
+ *
+ * \param root The root of the binding AST.
+ * \return 0 on success or -1 on memory exhaustion
+ */
+static int genbind_symbols_new(struct genbind_node *root)
+{
+        struct genbind_node *class;
+        struct genbind_node *ident_node;
+        int cidx;
+
+        genbind_symbols.classc = genbind_node_enumerate_type(
+                root, GENBIND_NODE_TYPE_CLASS);
+        genbind_symbols.classv = calloc(genbind_symbols.classc + 1,
+                                        sizeof(struct genbind_class_symbols));
+        genbind_symbols.classes = hashtable_new();
+        if ((genbind_symbols.classv == NULL) ||
+            (genbind_symbols.classes == NULL)) {
+                return -1;
+        }
+
+        cidx = 0;
+        class = genbind_node_find_type(root, NULL, GENBIND_NODE_TYPE_CLASS);
+        while (class != NULL) {
+                genbind_symbols.classv[cidx].class = class;
+                if (genbind_class_symbols_new(
+                            &genbind_symbols.classv[cidx]) != 0) {
+                        return -1;
+                }
+                cidx++;
+
+                /* the first class in search order with an identifier
+                 * is the one a search finds
+                 */
+                ident_node = genbind_node_find_type(
+                        genbind_node_getnode(class),
+                        NULL,
+                        GENBIND_NODE_TYPE_IDENT);
+                while (ident_node != NULL) {
+                        if ((hashtable_find(genbind_symbols.classes,
+                                            ident_node->r.text) == NULL) &&
+                            (hashtable_insert(genbind_symbols.classes,
+                                              ident_node->r.text,
+                                              class) != 0)) {
+                                return -1;
+                        }
+
+                        ident_node = genbind_node_find_type(
+                                genbind_node_getnode(class),
+                                ident_node,
+                                GENBIND_NODE_TYPE_IDENT);
+                }
+
+                class = genbind_node_find_type(root,
+                                               class,
+                                               GENBIND_NODE_TYPE_CLASS);
+        }
+
+        qsort(genbind_symbols.classv,
+              genbind_symbols.classc,
+              sizeof(struct genbind_class_symbols),
+              genbind_class_symbols_cmp);
+
+        genbind_symbols.root = root;
+
+        return 0;
+}
+
+/**
+ * release the symbol index of the binding
+ */
+static void genbind_symbols_free(void)
+{
+        struct genbind_class_symbols *cls;
+        int cidx;
+        int type;
+
+        if (genbind_symbols.classv != NULL) {
+                for (cidx = 0; cidx < genbind_symbols.classc; cidx++) {
+                        cls = &genbind_symbols.classv[cidx];
+                        for (type = 0;
+                             type < GENBIND_METHOD_TYPE_COUNT;
+                             type++) {
+                                hashtable_free(cls->ident[type]);
+                        }
+                }
+                free(genbind_symbols.classv);
+        }
+        hashtable_free(genbind_symbols.classes);
+
+        genbind_symbols.root = NULL;
+        genbind_symbols.classes = NULL;
+        genbind_symbols.classc = 0;
+        genbind_symbols.classv = NULL;
+}
+
+/* exported interface documented in nsgenbind-ast.h */
+void genbind_ast_free(void)
+{
+        nodeindex_free(genbind_nodeindex);
+        genbind_nodeindex = NULL;
+        genbind_symbols_free();
+
+        arena_free(genbind_arena);
+        genbind_arena = NULL;
+}
+
+/* exported interface documented in nsgenbind-ast.h */
 char *genbind_strapp(char *a, char *b)
 {
         char *fullstr;
-        int fulllen;
-        fulllen = strlen(a) + strlen(b) + 1;
-        fullstr = malloc(fulllen);
-        snprintf(fullstr, fulllen, "%s%s", a, b);
-        free(a);
-        free(b);
+        size_t alen;
+        size_t blen;
+
+        alen = strlen(a);
+        blen = strlen(b);
+        fullstr = genbind_alloc(alen + blen + 1);
+        memcpy(fullstr, a, alen);
+        memcpy(fullstr + alen, b, blen + 1);
         return fullstr;
 }
 
@@ -125,7 +421,7 @@ struct genbind_node *
 genbind_new_node(enum genbind_node_type type, struct genbind_node *l, void *r)
 {
         struct genbind_node *nn;
-        nn = calloc(1, sizeof(struct genbind_node));
+        nn = genbind_alloc(sizeof(struct genbind_node));
         nn->type = type;
         nn->l = l;
         nn->r.value = r;
@@ -138,7 +434,7 @@ genbind_new_number_node(enum genbind_node_type type,
                         int number)
 {
         struct genbind_node *nn;
-        nn = calloc(1, sizeof(struct genbind_node));
+        nn = genbind_alloc(sizeof(struct genbind_node));
         nn->type = type;
         nn->l = l;
         nn->r.number = number;
@@ -184,6 +480,15 @@ genbind_node_enumerate_type(struct genbind_node *node,
                             enum genbind_node_type type)
 {
         int count = 0;
+
+        if ((node != NULL) && (genbind_nodeindex != NULL)) {
+                count = nodeindex_count(genbind_nodeindex, node, type);
+                if (count >= 0) {
+                        return count;
+                }
+                count = 0;
+        }
+
         genbind_node_foreach_type(node,
                                   type,
                                   genbind_enumerate_node,
@@ -224,6 +529,14 @@ genbind_node_find_type(struct genbind_node *node,
                        struct genbind_node *prev,
                        enum genbind_node_type type)
 {
+        void *found;
+
+        if ((node != NULL) &&
+            (genbind_nodeindex != NULL) &&
+            (nodeindex_find(genbind_nodeindex, node, prev, type, &found) == 0)) {
+                return found;
+        }
+
         return genbind_node_find(node,
                                  prev,
                                  genbind_cmp_node_type,
@@ -244,6 +557,13 @@ genbind_node_find_type_ident(struct genbind_node *node,
                 return NULL;
         }
 
+        if ((node != NULL) &&
+            (node == genbind_symbols.root) &&
+            (prev == NULL) &&
+            (type == GENBIND_NODE_TYPE_CLASS)) {
+                return hashtable_find(genbind_symbols.classes, ident);
+        }
+
         found_node = genbind_node_find_type(node, prev, type);
 
         while (found_node != NULL) {
@@ -254,8 +574,8 @@ genbind_node_find_type_ident(struct genbind_node *node,
                         GENBIND_NODE_TYPE_IDENT);
 
                 while (ident_node != NULL) {
-                        /* check for matching text */
-                        if (strcmp(ident_node->r.text, ident) == 0) {
+                        /* identifiers are interned so compare pointers */
+                        if (ident_node->r.text == ident) {
                                 return found_node;
                         }
 
@@ -281,6 +601,13 @@ genbind_node_find_method(struct genbind_node *node,
                          enum genbind_method_type methodtype)
 {
         struct genbind_node *res_node;
+        struct genbind_class_symbols *cls;
+
+        if ((prev == NULL) &&
+            ((cls = genbind_class_symbols(node)) != NULL) &&
+            (methodtype < GENBIND_METHOD_TYPE_COUNT)) {
+                return cls->method[methodtype];
+        }
 
         res_node = genbind_node_find_type(
                 genbind_node_getnode(node),
@@ -315,8 +642,18 @@ genbind_node_find_method_ident(struct genbind_node *node,
                                const char *ident)
 {
         struct genbind_node *res_node;
+        struct genbind_class_symbols *cls;
         char *method_ident;
 
+        if ((prev == NULL) &&
+            ((cls = genbind_class_symbols(node)) != NULL) &&
+            (nodetype < GENBIND_METHOD_TYPE_COUNT)) {
+                if (ident == NULL) {
+                        return NULL;
+                }
+                return hashtable_find(cls->ident[nodetype], ident);
+        }
+
         res_node = genbind_node_find_method(node, prev, nodetype);
         while (res_node != NULL) {
               method_ident = genbind_node_gettext(
@@ -325,9 +662,8 @@ genbind_node_find_method_ident(struct genbind_node *node,
                               NULL,
                               GENBIND_NODE_TYPE_IDENT));
 
-              if ((ident != NULL) &&
-                  (method_ident != NULL) &&
-                  strcmp(ident, method_ident) == 0) {
+              /* identifiers are interned so compare pointers */
+              if ((ident != NULL) && (ident == method_ident)) {
                       break;
               }
 
@@ -492,6 +828,78 @@ static int genbind_ast_dump(FILE *dfile, struct genbind_node *node, int indent)
 }
 
 
+/* exported interface documented in nsgenbind-ast.h */
+uint64_t genbind_node_hash(struct genbind_node *node, uint64_t hash)
+{
+        struct genbind_node *child;
+        char *txt;
+        int *val;
+
+        if (node == NULL) {
+                return hash;
+        }
+
+        hash = genb_hash(hash, &node->type, sizeof(node->type));
+
+        /* file names are hashed as they appear in the output */
+        if (node->type == GENBIND_NODE_TYPE_FILE) {
+                txt = genb_mappath(genbind_node_gettext(node));
+                if (txt != NULL) {
+                        hash = genb_hash(hash, txt, strlen(txt) + 1);
+                        free(txt);
+                }
+                return hash;
+        }
+
+        txt = genbind_node_gettext(node);
+        if (txt != NULL) {
+                return genb_hash(hash, txt, strlen(txt) + 1);
+        }
+
+        val = genbind_node_getint(node);
+        if (val != NULL) {
+                return genb_hash(hash, val, sizeof(*val));
+        }
+
+        child = genbind_node_getnode(node);
+        while (child != NULL) {
+                hash = genbind_node_hash(child, hash);
+                child = child->l;
+        }
+
+        /* mark the end of the children so siblings cannot alias them */
+        return genb_hash(hash, "", 1);
+}
+
+/* exported interface documented in nsgenbind-ast.h */
+size_t genbind_node_textlen(struct genbind_node *node)
+{
+        struct genbind_node *child;
+        char *txt;
+        size_t len = 0;
+
+        if (node == NULL) {
+                return 0;
+        }
+
+        txt = genbind_node_gettext(node);
+        if (txt != NULL) {
+                return strlen(txt);
+        }
+
+        if (genbind_node_getint(node) != NULL) {
+                return 0;
+        }
+
+        child = genbind_node_getnode(node);
+        while (child != NULL) {
+                len += genbind_node_textlen(child);
+                child = child->l;
+        }
+
+        return len;
+}
+
 /* exported interface documented in nsgenbind-ast.h */
 int genbind_dump_ast(struct genbind_node *node)
 {
@@ -514,12 +922,83 @@ int genbind_dump_ast(struct genbind_node *node)
         return 0;
 }
 
+/**
+ * accumulate the memory used by nodes reachable from a node
+ */
+static void
+genbind_ast_memstats_walk(struct memstats_set *seen,
+                          struct memstats_entry *entries,
+                          struct genbind_node *node)
+{
+        struct memstats_entry *entry;
+        char *txt;
+
+        while ((node != NULL) && memstats_set_add(seen, node)) {
+                entry = &entries[node->type];
+                entry->count++;
+                entry->bytes += sizeof(struct genbind_node);
+
+                txt = genbind_node_gettext(node);
+                if (txt != NULL) {
+                        /* identifiers are interned and shared */
+                        if (memstats_set_add(seen, txt)) {
+                                entry->value_bytes += strlen(txt) + 1;
+                        }
+                } else {
+                        genbind_ast_memstats_walk(seen,
+                                                  entries,
+                                                  genbind_node_getnode(node));
+                }
+                node = node->l;
+        }
+}
+
+/* exported interface documented in nsgenbind-ast.h */
+int genbind_ast_memstats(FILE *outf, struct genbind_node *node)
+{
+        struct memstats_entry entries[GENBIND_NODE_TYPE_PARAMETER + 1];
+        struct memstats_entry total = { 0, 0, 0 };
+        struct memstats_set *seen;
+        size_t used;
+        size_t size;
+        int type;
+
+        seen = memstats_set_new();
+        if (seen == NULL) {
+                return -1;
+        }
+
+        memset(entries, 0, sizeof(entries));
+        genbind_ast_memstats_walk(seen, entries, node);
+        memstats_set_free(seen);
+
+        memstats_table_start(outf, "binding AST");
+        for (type = 0; type <= GENBIND_NODE_TYPE_PARAMETER; type++) {
+                memstats_table_row(outf,
+                                   genbind_node_type_to_str(type),
+                                   &entries[type]);
+                memstats_entry_add(&total, &entries[type]);
+        }
+        memstats_table_row(outf, "total", &total);
+
+        size = arena_usage(genbind_arena, &used);
+        fprintf(outf, "  arena %lu bytes allocated, %lu bytes used\n",
+                (unsigned long)size,
+                (unsigned long)used);
+
+        return 0;
+}
+
+/**
+ * directory of the binding being parsed, used to locate includes
+ */
+static char *prevfilepath = NULL;
+
 FILE *genbindopen(const char *filename)
 {
         FILE *genfile;
         char *fullname;
         int fulllen;
-        static char *prevfilepath = NULL;
 
         /* try filename raw */
         genfile = fopen(filename, "r");
@@ -527,6 +1006,7 @@ FILE *genbindopen(const char *filename)
                 if (options->verbose) {
                         printf("Opened Genbind file %s\n", filename);
                 }
+                depfile_add(filename);
                 if (prevfilepath == NULL) {
                         fullname = strrchr(filename, '/');
                         if (fullname == NULL) {
@@ -552,6 +1032,7 @@ FILE *genbindopen(const char *filename)
                         if (options->verbose) {
                                 printf("Opened Genbind file %s\n", fullname);
                         }
+                        depfile_add(fullname);
                         free(fullname);
                         return genfile;
                 }
@@ -564,14 +1045,11 @@ FILE *genbindopen(const char *filename)
                 fullname = malloc(fulllen);
                 snprintf(fullname, fulllen, "%s/%s", options->idlpath, filename);
                 genfile = fopen(fullname, "r");
-                if ((genfile != NULL) && options->verbose) {
-                        printf("Opend Genbind file %s\n", fullname);
-#if 0
-                        if (options->depfilehandle != NULL) {
-                                fprintf(options->depfilehandle, " \\\n\t%s",
-                                        fullname);
+                if (genfile != NULL) {
+                        if (options->verbose) {
+                                printf("Opend Genbind file %s\n", fullname);
                         }
-#endif
+                        depfile_add(fullname);
                 }
 
                 free(fullname);
@@ -581,11 +1059,40 @@ FILE *genbindopen(const char *filename)
 }
 
 
+static void *genbind_nodeindex_next(void *node)
+{
+        return ((struct genbind_node *)node)->l;
+}
+
+static unsigned int genbind_nodeindex_type(void *node)
+{
+        return ((struct genbind_node *)node)->type;
+}
+
+static void *genbind_nodeindex_child(void *node)
+{
+        return genbind_node_getnode(node);
+}
+
 int genbind_parsefile(char *infilename, struct genbind_node **ast)
 {
         FILE *infile;
+        void *scanner;
         int ret;
 
+        /* the AST of any previous binding is released with its arena */
+        genbind_ast_free();
+
+        genbind_arena = arena_new();
+        if (genbind_arena == NULL) {
+                fprintf(stderr, "Error: out of memory\n");
+                return 3;
+        }
+
+        /* includes are located relative to this binding */
+        free(prevfilepath);
+        prevfilepath = NULL;
+
         /* open input file */
         infile = genbindopen(infilename);
         if (!infile) {
@@ -595,20 +1102,46 @@ int genbind_parsefile(char *infilename, struct genbind_node **ast)
                 return 3;
         }
 
+        /* set flex to read from file */
+        if (nsgenbind_scanner_new(infile, &scanner) != 0) {
+                fprintf(stderr, "Error: out of memory\n");
+                fclose(infile);
+                return 3;
+        }
+
         /* if debugging enabled enable parser tracing and send to file */
         if (options->debug) {
                 nsgenbind_debug = 1;
-                nsgenbind__flex_debug = 1;
+                nsgenbind_set_debug(1, scanner);
                 genbind_parsetracef = genb_fopen("binding-trace", "w");
         } else {
                 genbind_parsetracef = NULL;
         }
 
-        /* set flex to read from file */
-        nsgenbind_restart(infile);
-
         /* process binding */
-        ret = nsgenbind_parse(infilename, ast);
+        ret = nsgenbind_parse(scanner, infilename, ast);
+
+        nsgenbind_scanner_free(scanner);
+
+        /* the AST is not altered once parsed so is indexed up front
+         * and queried by the output jobs without locking
+         */
+        if (ret == 0) {
+                genbind_nodeindex = nodeindex_new(genbind_nodeindex_next,
+                                                  genbind_nodeindex_type);
+                if ((genbind_nodeindex != NULL) &&
+                    (nodeindex_build(genbind_nodeindex,
+                                     *ast,
+                                     genbind_nodeindex_child) != 0)) {
+                        /* queries walk the AST instead */
+                        nodeindex_free(genbind_nodeindex);
+                        genbind_nodeindex = NULL;
+                }
+                if (genbind_symbols_new(*ast) != 0) {
+                        /* lookups walk the AST instead */
+                        genbind_symbols_free();
+                }
+        }
 
         /* close tracefile if open */
         if (genbind_parsetracef != NULL) {
@@ -9,6 +9,8 @@
 #ifndef nsgenbind_nsgenbind_ast_h
 #define nsgenbind_nsgenbind_ast_h
 
+#include <stdint.h>
+
 enum genbind_node_type {
         GENBIND_NODE_TYPE_ROOT = 0,
         GENBIND_NODE_TYPE_IDENT, /**< generic identifier string */
@@ -67,10 +69,47 @@ int genbind_cmp_node_type(struct genbind_node *node, void *ctx);
 
 FILE *genbindopen(const char *filename);
 
+/**
+ * parse a binding file
+ *
+ * The nodes and text of the AST are allocated from an arena created
+ * for the parse. Any AST from a previous parse is released first.
+ *
+ * \param infilename The binding file to parse.
+ * \param ast Updated with the root of the AST.
+ * \return 0 on success else an error code
+ */
 int genbind_parsefile(char *infilename, struct genbind_node **ast);
 
+/**
+ * concatenate two strings
+ *
+ * \param a The first string.
+ * \param b The string to append.
+ * \return the joined string allocated from the AST arena
+ */
 char *genbind_strapp(char *a, char *b);
 
+/**
+ * duplicate a string into storage owned by the AST
+ *
+ * The AST nodes and their text are allocated from the arena of the
+ * parse which is released by genbind_ast_free() or the next parse.
+ */
+char *genbind_strdup(const char *s);
+
+/**
+ * duplicate at most n characters of a string into storage owned by the AST
+ */
+char *genbind_strndup(const char *s, size_t n);
+
+/**
+ * release all nodes and text of the binding AST in one operation
+ *
+ * No reference to any node or text from the AST may be used afterwards.
+ */
+void genbind_ast_free(void);
+
 /**
  * create a new node with value from pointer
  */
@@ -100,6 +139,18 @@ struct genbind_node *genbind_node_add(struct genbind_node *node, struct genbind_
  */
 int genbind_dump_ast(struct genbind_node *node);
 
+/**
+ * write the memory used by the binding AST
+ *
+ * Reports the count and bytes of nodes of each type reachable from the
+ * node along with the bytes of their text.
+ *
+ * \param outf The file to write the report to.
+ * \param node Node of the tree to start from (usually tree root)
+ * \return 0 on success or -1 on memory exhaustion
+ */
+int genbind_ast_memstats(FILE *outf, struct genbind_node *node);
+
 /**
  *Depth first left hand search using user provided comparison
  *
@@ -156,7 +207,7 @@ genbind_node_enumerate_type(struct genbind_node *node,
  *             search the full tree depth (initial search) or the result
  *             of a previous search to continue.
  * @param nodetype The type of node to seach for
- * @param ident The text to match the ident child node to
+ * @param ident The interned text to match the ident child node to
  */
 struct genbind_node *
 genbind_node_find_type_ident(struct genbind_node *node,
@@ -189,7 +240,7 @@ genbind_node_find_method(struct genbind_node *node,
  *             search the full tree depth (initial search) or the result
  *             of a previous search to continue.
  * \param methodtype The type of method to find.
- * \param ident The identifier to search for
+ * \param ident The interned identifier to search for
  * \return A node of type GENBIND_NODE_TYPE_METHOD on success or NULL on faliure
  */
 struct genbind_node *
@@ -235,4 +286,25 @@ char *genbind_node_gettext(struct genbind_node *node);
  */
 int *genbind_node_getint(struct genbind_node *node);
 
+/**
+ * hash a node and all of its children
+ *
+ * The hash covers the type and value of every node in the subtree,
+ * including source locations, so any change to the binding a node was
+ * built from changes the result.
+ *
+ * \param node The node to hash, siblings of the node are not included.
+ * \param hash The hash to accumulate into.
+ * \return the updated hash
+ */
+uint64_t genbind_node_hash(struct genbind_node *node, uint64_t hash);
+
+/**
+ * get the length of all the text in a node and its children
+ *
+ * \param node The node to measure, siblings of the node are not included.
+ * \return the total length of the text
+ */
+size_t genbind_node_textlen(struct genbind_node *node);
+
 #endif
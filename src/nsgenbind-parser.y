@@ -90,25 +90,19 @@ typedef struct YYLTYPE {
 #include "nsgenbind-lexer.h"
 #include "webidl-ast.h"
 #include "nsgenbind-ast.h"
-
-static char *errtxt;
+#include "intern.h"
 
 static void nsgenbind_error(YYLTYPE *locp,
+                            void *scanner,
                             char *filename,
                             struct genbind_node **genbind_ast,
                             const char *str)
 {
-        int errlen;
-
+        UNUSED(scanner);
         UNUSED(genbind_ast);
         UNUSED(filename);
 
-        errlen = snprintf(NULL, 0, "%s:%d:%s",
-                          locp->filename, locp->first_line, str);
-        errtxt = malloc(errlen + 1);
-        snprintf(errtxt, errlen + 1, "%s:%d:%s",
-                          locp->filename, locp->first_line, str);
-
+        fprintf(stderr, "%s:%d:%s\n", locp->filename, locp->first_line, str);
 }
 
 static struct genbind_node *
@@ -149,7 +143,7 @@ add_method(struct genbind_node **genbind_ast,
                                 genbind_new_number_node(GENBIND_NODE_TYPE_LINE,
                                                         cdata_node,
                                                         lineno),
-                                         strdup(filename));
+                                         genbind_strdup(filename));
 
         /* generate method node */
         method_node = genbind_new_node(GENBIND_NODE_TYPE_METHOD,
@@ -181,8 +175,10 @@ add_method(struct genbind_node **genbind_ast,
 
 }
 
+%parse-param { void *scanner }
 %parse-param { char *filename }
 %parse-param { struct genbind_node **genbind_ast }
+%lex-param { void *scanner }
 
 %union
 {
@@ -272,8 +268,6 @@ Statements:
         |
         error ';'
         {
-                fprintf(stderr, "%s\n", errtxt);
-                free(errtxt);
                 YYABORT ;
         }
         ;
@@ -337,7 +331,7 @@ CTypeSpecifier:
                 $$ = genbind_new_node(GENBIND_NODE_TYPE_NAME,
                                       genbind_new_node(GENBIND_NODE_TYPE_NAME,
                                                        NULL,
-                                                       strdup("unsigned")),
+                                                       genbind_strdup("unsigned")),
                                       $2);
         }
         |
@@ -346,7 +340,7 @@ CTypeSpecifier:
                 $$ = genbind_new_node(GENBIND_NODE_TYPE_NAME,
                                       genbind_new_node(GENBIND_NODE_TYPE_NAME,
                                                        NULL,
-                                                       strdup("struct")),
+                                                       genbind_strdup("struct")),
                                       $2);
         }
         |
@@ -355,7 +349,7 @@ CTypeSpecifier:
                 $$ = genbind_new_node(GENBIND_NODE_TYPE_NAME,
                                       genbind_new_node(GENBIND_NODE_TYPE_NAME,
                                                        NULL,
-                                                       strdup("union")),
+                                                       genbind_strdup("union")),
                                       $2);
         }
         |
@@ -370,7 +364,7 @@ CType:
         |
         CTypeSpecifier '*'
         {
-                $$ = genbind_new_node(GENBIND_NODE_TYPE_NAME, $1, strdup("*"));
+                $$ = genbind_new_node(GENBIND_NODE_TYPE_NAME, $1, genbind_strdup("*"));
         }
 
  /* type and identifier of a variable */
@@ -387,7 +381,9 @@ CTypeIdent:
         }
         ;
 
-
+ /* the lexer returns each C code block as a single literal, adjacent
+  *  blocks are joined together
+  */
 CBlock:
         TOK_CCODE_LITERAL
         |
@@ -490,12 +486,12 @@ MethodName:
         |
         TOK_METHOD
         {
-                $$ = strdup("method");
+                $$ = intern_string("method");
         }
         |
         TOK_TYPE
         {
-                $$ = strdup("type");
+                $$ = intern_string("type");
         }
         ;
 
@@ -15,10 +15,17 @@
 #include <errno.h>
 
 #include "options.h"
+#include "intern.h"
+#include "depfile.h"
+#include "hashtable.h"
 #include "nsgenbind-ast.h"
 #include "webidl-ast.h"
+#include "webidl-cache.h"
 #include "ir.h"
 #include "output.h"
+#include "threadpool.h"
+#include "trace.h"
+#include "memstats.h"
 #include "jsapi-libdom.h"
 #include "duk-libdom.h"
 
@@ -30,6 +37,61 @@ enum bindingtype_e {
     BINDINGTYPE_DUK_LIBDOM,
 };
 
+/** options which only have a long form */
+enum long_options {
+        OPTION_TRACE = 256,
+        OPTION_MEM_STATS,
+        OPTION_PRUNE,
+        OPTION_SHARDS,
+        OPTION_CLASS_HEADERS,
+        OPTION_REPRODUCIBLE,
+        OPTION_FILE_PREFIX_MAP,
+};
+
+static const struct option long_options[] = {
+        { "trace", required_argument, NULL, OPTION_TRACE },
+        { "mem-stats", no_argument, NULL, OPTION_MEM_STATS },
+        { "prune", optional_argument, NULL, OPTION_PRUNE },
+        { "shards", required_argument, NULL, OPTION_SHARDS },
+        { "class-headers", no_argument, NULL, OPTION_CLASS_HEADERS },
+        { "reproducible", no_argument, NULL, OPTION_REPRODUCIBLE },
+        { "file-prefix-map", required_argument, NULL, OPTION_FILE_PREFIX_MAP },
+        { NULL, 0, NULL, 0 }
+};
+
+/**
+ * add a file prefix map to the options
+ *
+ * \param map The map in the form old=new.
+ * \return 0 on success else -1
+ */
+static int add_prefix_map(const char *map)
+{
+        char **prefixmapv;
+
+        if (strchr(map, '=') == NULL) {
+                fprintf(stderr, "Invalid file prefix map \"%s\"\n", map);
+                return -1;
+        }
+
+        prefixmapv = realloc(options->prefixmapv,
+                             (options->prefixmapc + 1) * sizeof(char *));
+        if (prefixmapv == NULL) {
+                fprintf(stderr, "Allocation error\n");
+                return -1;
+        }
+        options->prefixmapv = prefixmapv;
+
+        prefixmapv[options->prefixmapc] = strdup(map);
+        if (prefixmapv[options->prefixmapc] == NULL) {
+                fprintf(stderr, "Allocation error\n");
+                return -1;
+        }
+        options->prefixmapc++;
+
+        return 0;
+}
+
 static struct options* process_cmdline(int argc, char **argv)
 {
         int opt;
@@ -40,7 +102,13 @@ static struct options* process_cmdline(int argc, char **argv)
                 return NULL;
         }
 
-        while ((opt = getopt(argc, argv, "vngDW::I:")) != -1) {
+        options->jobs = 1;
+
+        while ((opt = getopt_long(argc,
+                                  argv,
+                                  "vngDW::I:j:M:C:",
+                                  long_options,
+                                  NULL)) != -1) {
                 switch (opt) {
                 case 'I':
                         options->idlpath = strdup(optarg);
@@ -62,6 +130,66 @@ static struct options* process_cmdline(int argc, char **argv)
                         options->dbglog = true;
                         break;
 
+                case 'j':
+                        options->jobs = strtoul(optarg, NULL, 10);
+                        if (options->jobs == 0) {
+                                fprintf(stderr,
+                                        "Invalid number of jobs \"%s\"\n",
+                                        optarg);
+                                free(options);
+                                return NULL;
+                        }
+                        break;
+
+                case 'C':
+                        options->cachedir = strdup(optarg);
+                        break;
+
+                case OPTION_TRACE:
+                        options->tracefilename = strdup(optarg);
+                        break;
+
+                case OPTION_MEM_STATS:
+                        options->memstats = true;
+                        break;
+
+                case OPTION_SHARDS:
+                        options->shards = strtoul(optarg, NULL, 10);
+                        if (options->shards == 0) {
+                                fprintf(stderr,
+                                        "Invalid number of shards \"%s\"\n",
+                                        optarg);
+                                free(options);
+                                return NULL;
+                        }
+                        break;
+
+                case OPTION_CLASS_HEADERS:
+                        options->classheaders = true;
+                        break;
+
+                case OPTION_REPRODUCIBLE:
+                        options->reproducible = true;
+                        break;
+
+                case OPTION_FILE_PREFIX_MAP:
+                        if (add_prefix_map(optarg) != 0) {
+                                free(options);
+                                return NULL;
+                        }
+                        break;
+
+                case OPTION_PRUNE:
+                        options->prune = true;
+                        if (optarg != NULL) {
+                                options->prunefilename = strdup(optarg);
+                        }
+                        break;
+
+                case 'M':
+                        options->depfilename = strdup(optarg);
+                        break;
+
                 case 'W':
                         if ((optarg == NULL) ||
                             (strcmp(optarg, "all") == 0)) {
@@ -86,64 +214,188 @@ static struct options* process_cmdline(int argc, char **argv)
 
                 default: /* '?' */
                         fprintf(stderr,
-                             "Usage: %s [-v] [-g] [-D] [-W] [-I idlpath] inputfile outputdir\n",
+                             "Usage: %s [-v] [-g] [-D] [-W] [-I idlpath] [-j jobs] [-M depfile] [-C cachedir] [--trace=file] [--mem-stats] [--prune[=file]] [--shards=count] [--class-headers] [--reproducible] [--file-prefix-map=old=new] inputfile outputdir [inputfile outputdir ...]\n",
                                 argv[0]);
                         free(options);
                         return NULL;
                 }
         }
 
-        if (optind > (argc - 2)) {
+        /* any number of binding and output directory pairs */
+        if ((optind > (argc - 2)) || (((argc - optind) % 2) != 0)) {
                 fprintf(stderr,
                        "Error: expected input filename and output directory\n");
                 free(options);
                 return NULL;
         }
 
-        options->infilename = strdup(argv[optind]);
-
-        options->outdirname = strdup(argv[optind + 1]);
+        options->bindingv = &argv[optind];
+        options->bindingc = (argc - optind) / 2;
 
         return options;
 
 }
 
+/**
+ * Web IDL files parsed for the bindings
+ *
+ * Each distinct file is parsed once and merged into the AST of every
+ * binding which lists it.
+ */
+struct webidl_files {
+        struct hashtable *index; /**< parse state by IDL filename */
+        unsigned int filec; /**< number of files */
+        struct webidl_parse **filev; /**< parse state of each file */
+        unsigned int parsed; /**< number of files already parsed */
+        struct webidl_node **webidl_ast; /**< AST being merged into */
+};
+
 static int webidl_file_cb(struct genbind_node *node, void *ctx)
 {
-	struct webidl_node **webidl_ast = ctx;
+        struct webidl_files *files = ctx;
+        struct webidl_parse **filev;
 	char *filename;
 
 	filename = genbind_node_gettext(node);
 
+        if (hashtable_find(files->index, filename) != NULL) {
+                /* already parsed for a previous binding */
+                return 0;
+        }
+
         if (options->verbose) {
                 printf("Opening IDL file \"%s\"\n", filename);
         }
 
-	return webidl_parsefile(filename, webidl_ast);
+        filev = realloc(files->filev,
+                        (files->filec + 1) * sizeof(struct webidl_parse *));
+        if (filev == NULL) {
+                fprintf(stderr, "Error: out of memory\n");
+                return -1;
+        }
+        files->filev = filev;
+
+        if (webidl_parse_new(filename, &files->filev[files->filec]) != 0) {
+                return 2;
+        }
+        /* the binding AST is released before the next binding is
+         * parsed so the key must outlive it
+         */
+        if (hashtable_insert(files->index,
+                             intern_string(filename),
+                             files->filev[files->filec]) != 0) {
+                webidl_parse_free(files->filev[files->filec]);
+                fprintf(stderr, "Error: out of memory\n");
+                return -1;
+        }
+        files->filec++;
+
+        return 0;
+}
+
+static int webidl_parse_job(void *ctx, unsigned int job)
+{
+        struct webidl_files *files = ctx;
+
+        return webidl_parse_run(files->filev[files->parsed + job]);
+}
+
+static int webidl_merge_cb(struct genbind_node *node, void *ctx)
+{
+        struct webidl_files *files = ctx;
+
+        webidl_parse_merge(hashtable_find(files->index,
+                                          genbind_node_gettext(node)),
+                           files->webidl_ast);
+        return 0;
+}
+
+/**
+ * parse the Web IDL files named by a binding
+ *
+ * Files not already parsed for a previous binding are opened in
+ * binding order so the verbose output and dependencies are stable and
+ * parsed concurrently. All the files are then merged in binding
+ * order.
+ */
+static int genbind_parse_idl(struct genbind_node *binding_node,
+                             struct webidl_files *files,
+                             struct webidl_node **webidl_ast)
+{
+        uint64_t start;
+        int res;
+
+        res = genbind_node_foreach_type(genbind_node_getnode(binding_node),
+                                        GENBIND_NODE_TYPE_WEBIDL,
+                                        webidl_file_cb,
+                                        files);
+        if (res != 0) {
+                return res;
+        }
+
+        res = threadpool_run(options->jobs,
+                             files->filec - files->parsed,
+                             webidl_parse_job,
+                             files);
+        if (res != 0) {
+                return res;
+        }
+        files->parsed = files->filec;
+        memstats_phase("webidl_parse");
+
+        start = trace_start();
+        files->webidl_ast = webidl_ast;
+        res = genbind_node_foreach_type(genbind_node_getnode(binding_node),
+                                        GENBIND_NODE_TYPE_WEBIDL,
+                                        webidl_merge_cb,
+                                        files);
+        trace_end(start, "webidl_parse_merge", NULL);
+        memstats_phase("webidl_parse_merge");
+
+        return res;
 }
 
 static int genbind_load_idl(struct genbind_node *genbind,
+                            struct webidl_files *files,
                             struct webidl_node **webidl_out)
 {
         int res;
         struct genbind_node *binding_node;
+        uint64_t cache_key;
+        bool cacheable = false;
+        uint64_t start;
 
         binding_node = genbind_node_find_type(genbind, NULL,
                                               GENBIND_NODE_TYPE_BINDING);
 
-	/* walk AST and load any web IDL files required */
-	res = genbind_node_foreach_type(
-                genbind_node_getnode(binding_node),
-                GENBIND_NODE_TYPE_WEBIDL,
-                webidl_file_cb,
-                webidl_out);
-	if (res != 0) {
-		fprintf(stderr, "Error: failed reading Web IDL\n");
-		return -1;
-	}
+        /* use the previously parsed IDL if none of the files changed */
+        if (options->cachedir != NULL) {
+                cacheable = (webidl_cache_key(binding_node, &cache_key) == 0);
+        }
+
+        if (cacheable && (webidl_cache_load(cache_key, webidl_out) == 0)) {
+                cacheable = false;
+        } else {
+                /* walk AST and load any web IDL files required */
+                start = trace_start();
+                res = genbind_parse_idl(binding_node, files, webidl_out);
+                trace_end(start, "genbind_parse_idl", NULL);
+                if (res != 0) {
+                        fprintf(stderr, "Error: failed reading Web IDL\n");
+                        return -1;
+                }
+        }
+
+        /* the cache holds the AST before implements are intercalated */
+        if (cacheable) {
+                webidl_cache_store(cache_key, *webidl_out);
+        }
 
         /* implements are implemented as mixins so intercalate them */
+        start = trace_start();
         res = webidl_intercalate_implements(*webidl_out);
+        trace_end(start, "webidl_intercalate_implements", NULL);
+        memstats_phase("webidl_intercalate_implements");
 	if (res != 0) {
 		fprintf(stderr, "Error: Failed to intercalate implements\n");
 		return -1;
@@ -191,24 +443,48 @@ static enum bindingtype_e genbind_get_type(struct genbind_node *node)
         return BINDINGTYPE_UNKNOWN;
 }
 
-int main(int argc, char **argv)
+/**
+ * report the memory used by the binding being processed
+ */
+static void
+genbind_memstats(struct genbind_node *genbind_root,
+                 struct webidl_node *webidl_root,
+                 struct ir *ir)
+{
+        printf("memory statistics for %s\n", options->infilename);
+        genbind_ast_memstats(stdout, genbind_root);
+        webidl_ast_memstats(stdout, webidl_root);
+        ir_memstats(stdout, ir);
+        memstats_phase_report(stdout);
+}
+
+/**
+ * generate the output for the binding being processed
+ *
+ * The binding AST, the merged Web IDL AST and the intermediate
+ * representation are released before returning so only the parsed
+ * IDL files are kept for the next binding.
+ *
+ * \param files The Web IDL files parsed for previous bindings.
+ * \return 0 on success else the exit code
+ */
+static int genbind_generate(struct webidl_files *files)
 {
         int res;
         struct genbind_node *genbind_root = NULL;
         struct webidl_node *webidl_root = NULL;
         struct ir *ir = NULL;
         enum bindingtype_e bindingtype;
-
-        options = process_cmdline(argc, argv);
-        if (options == NULL) {
-                return 1; /* bad commandline */
-        }
+        uint64_t start;
 
         /* parse binding */
+        start = trace_start();
         res = genbind_parsefile(options->infilename, &genbind_root);
+        trace_end(start, "genbind_parsefile", options->infilename);
+        memstats_phase("genbind_parsefile");
         if (res != 0) {
                 fprintf(stderr, "Error: parse failed with code %d\n", res);
-                return res;
+                goto generate_error;
         }
 
         /* dump the binding AST */
@@ -217,22 +493,42 @@ int main(int argc, char **argv)
         /* get type of binding */
         bindingtype = genbind_get_type(genbind_root);
         if (bindingtype == BINDINGTYPE_UNKNOWN) {
-                return 3;
+                res = 3;
+                goto generate_error;
         }
 
         /* load the IDL files specified in the binding */
-        res = genbind_load_idl(genbind_root, &webidl_root);
+        start = trace_start();
+        res = genbind_load_idl(genbind_root, files, &webidl_root);
+        trace_end(start, "genbind_load_idl", NULL);
         if (res != 0) {
-                return 4;
+                res = 4;
+                goto generate_error;
         }
 
 	/* debug dump of web idl AST */
         webidl_dump_ast(webidl_root);
 
         /* generate intermediate representation */
+        webidl_ast_index();
+        start = trace_start();
         res = ir_new(genbind_root, webidl_root, &ir);
+        trace_end(start, "ir_new", NULL);
+        memstats_phase("ir_new");
         if (res != 0) {
-                return 5;
+                res = 5;
+                goto generate_error;
+        }
+
+        /* remove the interfaces and dictionaries the binding cannot use */
+        if (options->prune) {
+                start = trace_start();
+                res = ir_prune(ir, options->prunefilename);
+                trace_end(start, "ir_prune", NULL);
+                if (res != 0) {
+                        res = 5;
+                        goto generate_error;
+                }
         }
 
         /* dump the intermediate representation */
@@ -242,7 +538,10 @@ int main(int argc, char **argv)
         /* generate binding */
         switch (bindingtype) {
         case BINDINGTYPE_DUK_LIBDOM:
+                start = trace_start();
                 res = duk_libdom_output(ir);
+                trace_end(start, "duk_libdom_output", options->outdirname);
+                memstats_phase("duk_libdom_output");
                 break;
 
         default:
@@ -250,5 +549,69 @@ int main(int argc, char **argv)
                 res = 7;
         }
 
+        if (options->memstats) {
+                genbind_memstats(genbind_root, webidl_root, ir);
+        }
+
+generate_error:
+        ir_free(ir);
+        webidl_ast_reset();
+        genbind_ast_free();
+
+        return res;
+}
+
+int main(int argc, char **argv)
+{
+        int res = 0;
+        struct webidl_files files = { NULL, 0, NULL, 0, NULL };
+        unsigned int idx;
+
+        options = process_cmdline(argc, argv);
+        if (options == NULL) {
+                return 1; /* bad commandline */
+        }
+
+        files.index = hashtable_new();
+        if (files.index == NULL) {
+                fprintf(stderr, "Allocation error\n");
+                return 1;
+        }
+
+        if ((options->tracefilename != NULL) &&
+            (trace_open(options->tracefilename) != 0)) {
+                return 1;
+        }
+
+        /* generate each binding in turn sharing the parsed IDL */
+        for (idx = 0; (res == 0) && (idx < options->bindingc); idx++) {
+                uint64_t start = trace_start();
+
+                options->infilename = options->bindingv[idx * 2];
+                options->outdirname = options->bindingv[(idx * 2) + 1];
+
+                res = genbind_generate(&files);
+
+                trace_end(start, "binding", options->infilename);
+        }
+
+        /* write the list of inputs read for the build system */
+        if ((res == 0) && (options->depfilename != NULL)) {
+                if (depfile_write(options->depfilename) != 0) {
+                        res = 8;
+                }
+        }
+        depfile_free();
+
+        for (idx = 0; idx < files.filec; idx++) {
+                webidl_parse_free(files.filev[idx]);
+        }
+        free(files.filev);
+        hashtable_free(files.index);
+
+        trace_close();
+
+        intern_free();
+
         return res;
 }
@@ -11,14 +11,31 @@
 
 /** global options */
 struct options {
-	char *infilename; /**< binding source */
-	char *outdirname; /**< output directory */
+	char *infilename; /**< binding source being processed */
+	char *outdirname; /**< output directory being processed */
+	char **bindingv; /**< binding source and output directory pairs */
+	unsigned int bindingc; /**< number of binding pairs */
 	char *idlpath; /**< path to IDL files */
+	char *depfilename; /**< dependency file to write */
+	char *cachedir; /**< directory to cache parsed IDL in */
+	char *tracefilename; /**< file to write timing trace to */
+	char *prunefilename; /**< file listing interfaces to keep */
+	char **prefixmapv; /**< old=new prefixes of input paths in output */
+	unsigned int prefixmapc; /**< number of prefix maps */
 
 	bool verbose; /**< verbose processing */
 	bool debug; /**< debug enabled */
 	bool dbglog; /**< embed debug logging in output */
         bool dryrun; /**< output is not generated */
+	bool memstats; /**< report memory use of each binding */
+	bool prune; /**< only generate interfaces the binding can use */
+	bool classheaders; /**< generate private and prototype headers per class */
+	bool reproducible; /**< output does not depend on the output directory */
+
+	unsigned int jobs; /**< number of output generation threads */
+	unsigned int shards; /**< number of files the interfaces are output
+			      * in or zero for a file each
+			      */
 
 	unsigned int warnings; /**< warning flags */
 };
@@ -13,13 +13,66 @@
 
 #include "utils.h"
 #include "output.h"
+#include "trace.h"
+
+/** initial size of the output buffer */
+#define OUTPUT_BUFFER_SIZE (16 * 1024)
 
 struct opctx {
     char *filename;
-    FILE *outf;
     unsigned int lineno;
+    char *buffer; /**< buffer holding the entire generated output */
+    size_t buffer_size; /**< allocated size of output buffer */
+    size_t length; /**< length of output in buffer */
 };
 
+/**
+ * ensure there is space in the output buffer
+ *
+ * \param opctx The output context.
+ * \param len The number of bytes required after the current output.
+ * \return 0 on success or -1 on memory exhaustion
+ */
+static int output_reserve(struct opctx *opctx, size_t len)
+{
+        char *buffer;
+        size_t size;
+
+        if ((opctx->length + len) <= opctx->buffer_size) {
+                return 0;
+        }
+
+        size = opctx->buffer_size * 2;
+        while (size < (opctx->length + len)) {
+                size *= 2;
+        }
+
+        buffer = realloc(opctx->buffer, size);
+        if (buffer == NULL) {
+                return -1;
+        }
+        opctx->buffer = buffer;
+        opctx->buffer_size = size;
+
+        return 0;
+}
+
+/**
+ * account for the newlines in a block of output
+ *
+ * memchr is used as it is optimised to examine many bytes at once.
+ */
+static void
+output_count_lines(struct opctx *opctx, const char *data, size_t len)
+{
+        const char *end = data + len;
+
+        while ((data = memchr(data, '\n', end - data)) != NULL) {
+                opctx->lineno++;
+                data++;
+        }
+}
+
 int output_open(const char *filename, struct opctx **opctx_out)
 {
         struct opctx *opctx;
@@ -35,13 +88,15 @@ int output_open(const char *filename, struct opctx **opctx_out)
                 return -1;
         }
 
-        /* open output file */
-        opctx->outf = genb_fopen_tmp(opctx->filename);
-        if (opctx->outf == NULL) {
+        /* output is accumulated in memory until the context is closed */
+        opctx->buffer_size = OUTPUT_BUFFER_SIZE;
+        opctx->buffer = malloc(opctx->buffer_size);
+        if (opctx->buffer == NULL) {
                 free(opctx->filename);
                 free(opctx);
                 return -1;
         }
+        opctx->length = 0;
 
         opctx->lineno = 2;
         *opctx_out = opctx;
@@ -52,55 +107,87 @@ int output_open(const char *filename, struct opctx **opctx_out)
 int output_close(struct opctx *opctx)
 {
         int res;
-        res = genb_fclose_tmp(opctx->outf, opctx->filename);
+
+        trace_count(TRACE_COUNTER_OUTPUT_BYTES, opctx->length);
+
+        res = genb_fupdate(opctx->filename, opctx->buffer, opctx->length);
+        free(opctx->buffer);
         free(opctx->filename);
         free(opctx);
         return res;
 }
 
-/**
- * buffer to hold formatted output so newlines can be counted
- */
-static char output_buffer[128*1024];
-
 int outputf(struct opctx *opctx, const char *fmt, ...)
 {
         va_list ap;
         int res;
-        int idx;
 
+        /* format directly into the output buffer */
         va_start(ap, fmt);
-        res = vsnprintf(output_buffer, sizeof(output_buffer), fmt, ap);
+        res = vsnprintf(opctx->buffer + opctx->length,
+                        opctx->buffer_size - opctx->length,
+                        fmt, ap);
         va_end(ap);
+        if (res < 0) {
+                return res;
+        }
 
-        /* account for newlines in output */
-        for (idx = 0; idx < res; idx++) {
-                if (output_buffer[idx] == '\n') {
-                        opctx->lineno++;
+        if ((opctx->length + res) >= opctx->buffer_size) {
+                /* output did not fit, grow the buffer and try again */
+                if (output_reserve(opctx, res + 1) != 0) {
+                        return -1;
                 }
+
+                va_start(ap, fmt);
+                res = vsnprintf(opctx->buffer + opctx->length,
+                                opctx->buffer_size - opctx->length,
+                                fmt, ap);
+                va_end(ap);
         }
 
-        fwrite(output_buffer, 1, res, opctx->outf);
+        output_count_lines(opctx, opctx->buffer + opctx->length, res);
+
+        opctx->length += res;
 
         return res;
 }
 
+int outputn(struct opctx *opctx, const char *data, size_t len)
+{
+        if (output_reserve(opctx, len) != 0) {
+                return -1;
+        }
+
+        memcpy(opctx->buffer + opctx->length, data, len);
+        output_count_lines(opctx, data, len);
+
+        opctx->length += len;
+
+        return len;
+}
+
+int outputs(struct opctx *opctx, const char *str)
+{
+        return outputn(opctx, str, strlen(str));
+}
+
 int outputc(struct opctx *opctx, int c)
 {
+        if (output_reserve(opctx, 1) != 0) {
+                return -1;
+        }
+
         if (c == '\n') {
                 opctx->lineno++;
         }
-        fputc(c, opctx->outf);
+        opctx->buffer[opctx->length++] = c;
 
         return 0;
 }
 
 int output_line(struct opctx *opctx)
 {
-        int res;
-        res = fprintf(opctx->outf,
-                      "#line %d \"%s\"\n",
-                      opctx->lineno, opctx->filename);
-        opctx->lineno++;
-        return res;
+        return outputf(opctx,
+                       "#line %d \"%s\"\n",
+                       opctx->lineno, opctx->filename);
 }
@@ -9,12 +9,15 @@
 #ifndef nsgenbind_output_h
 #define nsgenbind_output_h
 
+#include <stddef.h>
+
 struct opctx;
 
 /**
  * open output file
  *
- * opens output file and creates output context
+ * creates output context, the output is held in memory until the
+ * context is closed
  *
  * \param filename The filename of the file to output
  * \param opctx_out The resulting output context
@@ -24,6 +27,8 @@ int output_open(const char *filename, struct opctx **opctx_out);
 
 /**
  * close output file and free context
+ *
+ * the output file is only written if its contents have changed
  */
 int output_close(struct opctx *opctx);
 
@@ -32,6 +37,24 @@ int output_close(struct opctx *opctx);
  */
 int outputf(struct opctx *opctx, const char *fmt, ...) __attribute__ ((format (printf, 2, 3)));
 
+/**
+ * output a string to file
+ *
+ * The string is copied to the output as it is without being
+ * formatted so is preferred for literal text and code blocks.
+ */
+int outputs(struct opctx *opctx, const char *str);
+
+/**
+ * output a block of data to file
+ *
+ * \param opctx The output context.
+ * \param data The data to output.
+ * \param len The length of the data.
+ * \return the number of bytes output or -1 on memory exhaustion
+ */
+int outputn(struct opctx *opctx, const char *data, size_t len);
+
 int outputc(struct opctx *opctx, int c);
 
 /**
@@ -0,0 +1,122 @@
+/* worker thread pool implementation
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "threadpool.h"
+
+struct threadpool {
+        pthread_mutex_t lock; /**< protects next and error fields */
+        unsigned int next; /**< index of next job to hand out */
+        unsigned int jobc; /**< total number of jobs */
+        unsigned int error_job; /**< lowest index of a failed job */
+        int error; /**< result of lowest index failed job */
+        threadpool_job_t *job;
+        void *ctx;
+};
+
+static void *threadpool_worker(void *arg)
+{
+        struct threadpool *pool = arg;
+        unsigned int job;
+        int res;
+
+        for (;;) {
+                pthread_mutex_lock(&pool->lock);
+                job = pool->next;
+                if (job < pool->jobc) {
+                        pool->next++;
+                }
+                pthread_mutex_unlock(&pool->lock);
+
+                if (job >= pool->jobc) {
+                        break;
+                }
+
+                res = pool->job(pool->ctx, job);
+                if (res != 0) {
+                        pthread_mutex_lock(&pool->lock);
+                        if ((pool->error == 0) || (job < pool->error_job)) {
+                                pool->error = res;
+                                pool->error_job = job;
+                        }
+                        pthread_mutex_unlock(&pool->lock);
+                }
+        }
+        return NULL;
+}
+
+/* exported interface documented in threadpool.h */
+int threadpool_run(unsigned int threads,
+                   unsigned int jobc,
+                   threadpool_job_t *job,
+                   void *ctx)
+{
+        struct threadpool pool;
+        pthread_t *workers;
+        unsigned int started;
+        unsigned int idx;
+        int res;
+
+        if (threads > jobc) {
+                threads = jobc;
+        }
+
+        if (threads <= 1) {
+                /* serial processing on the calling thread */
+                for (idx = 0; idx < jobc; idx++) {
+                        res = job(ctx, idx);
+                        if (res != 0) {
+                                return res;
+                        }
+                }
+                return 0;
+        }
+
+        workers = calloc(threads, sizeof(pthread_t));
+        if (workers == NULL) {
+                return -1;
+        }
+
+        pthread_mutex_init(&pool.lock, NULL);
+        pool.next = 0;
+        pool.jobc = jobc;
+        pool.error_job = 0;
+        pool.error = 0;
+        pool.job = job;
+        pool.ctx = ctx;
+
+        for (started = 0; started < threads; started++) {
+                res = pthread_create(&workers[started],
+                                     NULL,
+                                     threadpool_worker,
+                                     &pool);
+                if (res != 0) {
+                        fprintf(stderr,
+                                "Error: unable to create worker thread: %s\n",
+                                strerror(res));
+                        break;
+                }
+        }
+
+        if (started == 0) {
+                /* no workers could be created so do the work here */
+                threadpool_worker(&pool);
+        }
+
+        for (idx = 0; idx < started; idx++) {
+                pthread_join(workers[idx], NULL);
+        }
+
+        pthread_mutex_destroy(&pool.lock);
+        free(workers);
+
+        return pool.error;
+}
@@ -0,0 +1,42 @@
+/* worker thread pool
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ */
+
+#ifndef nsgenbind_threadpool_h
+#define nsgenbind_threadpool_h
+
+/**
+ * job callback
+ *
+ * \param ctx The context passed to threadpool_run()
+ * \param job The index of the job to perform.
+ * \return 0 on success else an error code
+ */
+typedef int (threadpool_job_t)(void *ctx, unsigned int job);
+
+/**
+ * run a set of independent jobs on a pool of worker threads
+ *
+ * Each job index from zero to jobc - 1 is passed to the callback exactly
+ * once. Jobs are handed out in index order but may complete in any
+ * order so they must not share mutable state.
+ *
+ * With a single thread the jobs are run in order on the calling thread
+ * and processing stops at the first job to fail.
+ *
+ * \param threads The number of worker threads to use.
+ * \param jobc The number of jobs.
+ * \param job The callback to perform a job.
+ * \param ctx Context passed to the callback.
+ * \return 0 if every job succeeded else the error code of the failing job
+ *         with the lowest index.
+ */
+int threadpool_run(unsigned int threads,
+                   unsigned int jobc,
+                   threadpool_job_t *job,
+                   void *ctx);
+
+#endif
@@ -0,0 +1,240 @@
+/* generator phase timing trace implementation
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "trace.h"
+
+/** counter names and the argument their value is reported as */
+static const struct {
+        const char *name;
+        const char *arg;
+} trace_counter_name[TRACE_COUNTER_COUNT] = {
+        { "webidl_node_find_type", "calls" },
+        { "output", "bytes" },
+};
+
+/**
+ * file the trace is written to or NULL when not tracing.
+ */
+static FILE *trace_file;
+
+/**
+ * serialises writing events from concurrent jobs.
+ */
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * threads seen so far, the index is the trace thread id.
+ */
+static pthread_t *trace_threadv;
+static unsigned int trace_threadc;
+
+/**
+ * time the trace was opened.
+ */
+static uint64_t trace_epoch;
+
+/**
+ * current counter values.
+ */
+static unsigned long trace_counters[TRACE_COUNTER_COUNT];
+
+/**
+ * counter values last written to the trace.
+ */
+static unsigned long trace_counters_written[TRACE_COUNTER_COUNT];
+
+/**
+ * monotonic time in microseconds
+ */
+static uint64_t trace_now(void)
+{
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+
+        return ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+
+/**
+ * write a string as a JSON string value
+ */
+static void trace_write_string(const char *str)
+{
+        fputc('"', trace_file);
+        for (; *str != 0; str++) {
+                if ((*str == '"') || (*str == '\\')) {
+                        fprintf(trace_file, "\\%c", *str);
+                } else if ((unsigned char)*str < 0x20) {
+                        fprintf(trace_file, "\\u%04x", (unsigned char)*str);
+                } else {
+                        fputc(*str, trace_file);
+                }
+        }
+        fputc('"', trace_file);
+}
+
+/**
+ * get the trace id of the calling thread
+ *
+ * The caller must hold trace_lock. Threads are numbered in the order
+ * they first record an event and named in the trace as they are seen.
+ */
+static unsigned int trace_tid(void)
+{
+        pthread_t self = pthread_self();
+        pthread_t *threadv;
+        unsigned int tid;
+
+        for (tid = 0; tid < trace_threadc; tid++) {
+                if (pthread_equal(trace_threadv[tid], self)) {
+                        return tid;
+                }
+        }
+
+        threadv = realloc(trace_threadv,
+                          (trace_threadc + 1) * sizeof(pthread_t));
+        if (threadv == NULL) {
+                /* attribute the event to the main thread */
+                return 0;
+        }
+        trace_threadv = threadv;
+        trace_threadv[trace_threadc] = self;
+
+        fprintf(trace_file,
+                ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+                "\"tid\":%u,\"args\":{\"name\":",
+                (int)getpid(),
+                tid);
+        if (tid == 0) {
+                fprintf(trace_file, "\"main\"}}");
+        } else {
+                fprintf(trace_file, "\"worker %u\"}}", tid);
+        }
+
+        return trace_threadc++;
+}
+
+/* exported interface documented in trace.h */
+int trace_open(const char *filename)
+{
+        trace_file = fopen(filename, "w");
+        if (trace_file == NULL) {
+                fprintf(stderr, "Error: unable to open trace %s\n", filename);
+                return -1;
+        }
+
+        trace_epoch = trace_now();
+
+        fprintf(trace_file,
+                "{\"traceEvents\":[\n"
+                "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+                "\"tid\":0,\"args\":{\"name\":\"nsgenbind\"}}",
+                (int)getpid());
+
+        /* the opening thread is always the first */
+        pthread_mutex_lock(&trace_lock);
+        trace_tid();
+        pthread_mutex_unlock(&trace_lock);
+
+        return 0;
+}
+
+/* exported interface documented in trace.h */
+void trace_close(void)
+{
+        if (trace_file == NULL) {
+                return;
+        }
+
+        fprintf(trace_file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+        fclose(trace_file);
+        trace_file = NULL;
+
+        free(trace_threadv);
+        trace_threadv = NULL;
+        trace_threadc = 0;
+}
+
+/* exported interface documented in trace.h */
+uint64_t trace_start(void)
+{
+        if (trace_file == NULL) {
+                return 0;
+        }
+        return trace_now();
+}
+
+/* exported interface documented in trace.h */
+void trace_end(uint64_t start, const char *name, const char *detail)
+{
+        uint64_t end;
+        unsigned long value;
+        unsigned int tid;
+        int counter;
+
+        if (trace_file == NULL) {
+                return;
+        }
+
+        end = trace_now();
+
+        pthread_mutex_lock(&trace_lock);
+
+        tid = trace_tid();
+
+        fprintf(trace_file, ",\n{\"name\":");
+        trace_write_string(name);
+        fprintf(trace_file,
+                ",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,"
+                "\"ts\":%llu,\"dur\":%llu",
+                (int)getpid(),
+                tid,
+                (unsigned long long)(start - trace_epoch),
+                (unsigned long long)(end - start));
+        if (detail != NULL) {
+                fprintf(trace_file, ",\"args\":{\"detail\":");
+                trace_write_string(detail);
+                fputc('}', trace_file);
+        }
+        fputc('}', trace_file);
+
+        /* sample the counters which changed during the span */
+        for (counter = 0; counter < TRACE_COUNTER_COUNT; counter++) {
+                value = __sync_fetch_and_add(&trace_counters[counter], 0);
+                if (value != trace_counters_written[counter]) {
+                        fprintf(trace_file,
+                                ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":%d,"
+                                "\"ts\":%llu,\"args\":{\"%s\":%lu}}",
+                                trace_counter_name[counter].name,
+                                (int)getpid(),
+                                (unsigned long long)(end - trace_epoch),
+                                trace_counter_name[counter].arg,
+                                value);
+                        trace_counters_written[counter] = value;
+                }
+        }
+
+        pthread_mutex_unlock(&trace_lock);
+}
+
+/* exported interface documented in trace.h */
+void trace_count(enum trace_counter counter, unsigned long value)
+{
+        if (trace_file == NULL) {
+                return;
+        }
+
+        /* counted from concurrent output jobs without taking the lock */
+        __sync_fetch_and_add(&trace_counters[counter], value);
+}
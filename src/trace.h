@@ -0,0 +1,67 @@
+/* generator phase timing trace
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ */
+
+#ifndef nsgenbind_trace_h
+#define nsgenbind_trace_h
+
+#include <stdint.h>
+
+/** counters sampled into the trace */
+enum trace_counter {
+        TRACE_COUNTER_FIND_TYPE, /**< webidl_node_find_type() calls */
+        TRACE_COUNTER_OUTPUT_BYTES, /**< bytes of generated output */
+        TRACE_COUNTER_COUNT,
+};
+
+/**
+ * start writing a trace
+ *
+ * The trace is written in the Chrome trace event JSON format which
+ * may be loaded into chrome://tracing or Perfetto. Until a trace is
+ * opened all the other trace calls do nothing.
+ *
+ * \param filename The file to write the trace to.
+ * \return 0 on success else -1
+ */
+int trace_open(const char *filename);
+
+/**
+ * finish the trace and close the file
+ */
+void trace_close(void);
+
+/**
+ * get the start time of a span
+ *
+ * \return timestamp to pass to trace_end()
+ */
+uint64_t trace_start(void);
+
+/**
+ * record a span which has finished
+ *
+ * The span is recorded on the calling thread so spans from concurrent
+ * jobs are shown separately. The current counter values are recorded
+ * at the end of every span.
+ *
+ * \param start The timestamp from trace_start()
+ * \param name The name of the span.
+ * \param detail Text identifying the span instance or NULL
+ */
+void trace_end(uint64_t start, const char *name, const char *detail);
+
+/**
+ * add to a counter
+ *
+ * May be called from any thread.
+ *
+ * \param counter The counter to add to.
+ * \param value The amount to add.
+ */
+void trace_count(enum trace_counter counter, unsigned long value);
+
+#endif
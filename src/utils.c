@@ -12,6 +12,9 @@
 #include <errno.h>
 #include <stdlib.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <unistd.h>
 
 #include "options.h"
@@ -30,14 +33,45 @@ char *genb_fpath(const char *fname)
         return fpath;
 }
 
+/* exported function documented in utils.h */
+char *genb_mappath(const char *path)
+{
+        const char *map;
+        const char *sep;
+        char *mapped;
+        unsigned int idx;
+        int mappedl;
+
+        /* the last matching map is used */
+        for (idx = options->prefixmapc; idx > 0; idx--) {
+                map = options->prefixmapv[idx - 1];
+                sep = strchr(map, '=');
+                if (strncmp(path, map, sep - map) == 0) {
+                        mappedl = strlen(sep + 1) +
+                                strlen(path + (sep - map)) + 1;
+                        mapped = malloc(mappedl);
+                        if (mapped != NULL) {
+                                snprintf(mapped, mappedl, "%s%s",
+                                         sep + 1,
+                                         path + (sep - map));
+                        }
+                        return mapped;
+                }
+        }
+
+        return strdup(path);
+}
+
 static char *genb_fpath_tmp(const char *fname)
 {
         char *fpath;
         int fpathl;
 
-        fpathl = strlen(options->outdirname) + strlen(fname) + 3;
+        fpathl = snprintf(NULL, 0, "%s/%s.%d",
+                          options->outdirname, fname, (int)getpid()) + 1;
         fpath = malloc(fpathl);
-        snprintf(fpath, fpathl, "%s/%s.%d", options->outdirname, fname, getpid());
+        snprintf(fpath, fpathl, "%s/%s.%d",
+                 options->outdirname, fname, (int)getpid());
 
         return fpath;
 }
@@ -66,90 +100,130 @@ FILE *genb_fopen(const char *fname, const char *mode)
         return filef;
 }
 
-/* exported function documented in utils.h */
-FILE *genb_fopen_tmp(const char *fname)
+/**
+ * check if a file already has the given contents
+ *
+ * The sizes are compared first so the file contents only need to be
+ * examined when the sizes match.
+ */
+static bool genb_fsame(const char *fpath, const char *data, size_t len)
 {
-        char *fpath;
-        FILE *filef;
+        struct stat st;
+        void *map;
+        bool same;
+        int fd;
+
+        fd = open(fpath, O_RDONLY);
+        if (fd == -1) {
+                return false;
+        }
 
-        if (options->dryrun) {
-                fpath = strdup("/dev/null");
-        } else {
-                fpath = genb_fpath_tmp(fname);
+        if ((fstat(fd, &st) != 0) || (st.st_size != (off_t)len)) {
+                close(fd);
+                return false;
         }
 
-        filef = fopen(fpath, "w+");
-        if (filef == NULL) {
-                fprintf(stderr, "Error: unable to open file %s (%s)\n",
-                        fpath, strerror(errno));
-                free(fpath);
-                return NULL;
+        if (len == 0) {
+                close(fd);
+                return true;
         }
-        free(fpath);
 
-        return filef;
+        map = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) {
+                return false;
+        }
+
+        same = (memcmp(map, data, len) == 0);
+
+        munmap(map, len);
+
+        return same;
 }
 
-int genb_fclose_tmp(FILE *filef_tmp, const char *fname)
+/* exported function documented in utils.h */
+int genb_fupdate(const char *fname, const char *data, size_t len)
 {
         char *fpath;
         char *tpath;
         FILE *filef;
-        char tbuf[1024];
-        char fbuf[1024];
-        size_t trd;
-        size_t frd;
+        int res = 0;
 
         if (options->dryrun) {
-                fclose(filef_tmp);
                 return 0;
         }
 
         fpath = genb_fpath(fname);
+
+        if (genb_fsame(fpath, data, len)) {
+                /* unchanged so leave the existing file untouched */
+                free(fpath);
+                return 0;
+        }
+
+        /* write to a temporary file and move it into place */
         tpath = genb_fpath_tmp(fname);
 
-        filef = fopen(fpath, "r");
+        filef = fopen(tpath, "w");
         if (filef == NULL) {
-                /* unable to open target file for comparison */
+                fprintf(stderr, "Error: unable to open file %s (%s)\n",
+                        tpath, strerror(errno));
+                free(tpath);
+                free(fpath);
+                return -1;
+        }
 
-                fclose(filef_tmp); /*  close tmpfile */
+        if (fwrite(data, 1, len, filef) != len) {
+                res = -1;
+        }
+        if (fclose(filef) != 0) {
+                res = -1;
+        }
 
+        if (res == 0) {
                 remove(fpath);
-                rename(tpath, fpath);
-        } else {
-                rewind(filef_tmp);
+                if (rename(tpath, fpath) != 0) {
+                        res = -1;
+                }
+        }
 
-                frd = fread(fbuf, 1, 1024, filef);
-                while (frd != 0) {
-                        trd = fread(tbuf, 1, frd, filef_tmp);
-                        if ((trd != frd) ||
-                            (memcmp(tbuf, fbuf, trd) != 0)) {
-                                /* file doesnt match */
-                                fclose(filef_tmp);
-                                fclose(filef);
+        if (res != 0) {
+                fprintf(stderr, "Error: unable to write file %s (%s)\n",
+                        fpath, strerror(errno));
+                remove(tpath);
+        }
 
-                                remove(fpath);
-                                rename(tpath, fpath);
+        free(tpath);
+        free(fpath);
 
-                                goto close_done;
-                        }
+        return res;
+}
 
-                        frd = fread(fbuf, 1, 1024, filef);
-                }
 
-                /* was the same kill temporary file */
-                fclose(filef_tmp);
-                fclose(filef);
-                remove(tpath);
-        }
+/* exported function documented in utils.h */
+bool genb_fexists(const char *fname)
+{
+        char *fpath;
+        int res;
 
-close_done:
+        fpath = genb_fpath(fname);
+        res = access(fpath, F_OK);
         free(fpath);
-        free(tpath);
 
-        return 0;
+        return (res == 0);
 }
 
+/* exported function documented in utils.h */
+uint64_t genb_hash(uint64_t hash, const void *data, size_t len)
+{
+        const uint8_t *byte = data;
+
+        while (len-- > 0) {
+                hash ^= *byte++;
+                hash *= 1099511628211ULL;
+        }
+        return hash;
+}
 
 #ifdef NEED_STRNDUP
 
@@ -9,6 +9,10 @@
 #ifndef nsgenbind_utils_h
 #define nsgenbind_utils_h
 
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
 /**
  * get a pathname with the output prefix prepended
  *
@@ -17,24 +21,59 @@
  */
 char *genb_fpath(const char *fname);
 
+/**
+ * get a pathname of an input with the file prefix maps applied
+ *
+ * The last map whose old prefix matches the start of the path has the
+ * prefix replaced by its new prefix. Paths no map matches are
+ * unchanged.
+ *
+ * \param path The path of an input file.
+ * \return the mapped path caller must free or NULL on memory exhaustion
+ */
+char *genb_mappath(const char *path);
+
 /**
  * Open file allowing for output path prefix
  */
 FILE *genb_fopen(const char *fname, const char *mode);
 
 /**
- * Open file allowing for output path prefix
+ * Update file allowing for output path prefix
  *
- * file is opened for reading/writing with a temporary suffix allowing for the
- * matching close call to check the output is different before touching the
- * target file.
+ * The existing file is compared with the new contents, by size and then
+ * by content, and is only replaced if they differ so unchanged output
+ * never touches the target file.
+ *
+ * \param fname leaf filename.
+ * \param data The new contents of the file.
+ * \param len The length of the new contents.
+ * \return 0 on success else -1
  */
-FILE *genb_fopen_tmp(const char *fname);
+int genb_fupdate(const char *fname, const char *data, size_t len);
 
 /**
- * Close file opened with genb_fopen
+ * check if a file exists allowing for output path prefix
+ *
+ * \param fname leaf filename.
+ * \return true if the file exists else false
+ */
+bool genb_fexists(const char *fname);
+
+/** initial value of a hash computed with genb_hash() */
+#define GENB_HASH_INIT 14695981039346656037ULL
+
+/**
+ * accumulate data into a hash
+ *
+ * 64bit FNV-1a hash used to detect changes in generator inputs
+ *
+ * \param hash The hash so far, GENB_HASH_INIT for a new hash.
+ * \param data The data to add to the hash.
+ * \param len The length of the data.
+ * \return the updated hash
  */
-int genb_fclose_tmp(FILE *filef, const char *fname);
+uint64_t genb_hash(uint64_t hash, const void *data, size_t len);
 
 #if defined(__APPLE__) || defined(_WIN32)
 #define NEED_STRNDUP 1
@@ -14,18 +14,71 @@
 #include <stdarg.h>
 
 #include "utils.h"
+#include "arena.h"
+#include "depfile.h"
+#include "hashtable.h"
+#include "intern.h"
 #include "webidl-ast.h"
 #include "options.h"
+#include "trace.h"
+#include "memstats.h"
+#include "nodeindex.h"
 
 /**
- * standard IO handle for parse trace logging.
+ * arena owning the nodes and text of the merged AST.
+ *
+ * The definitions copied by the merge, intercalated implements and
+ * ASTs loaded from the cache are allocated from it. Only the serial
+ * merge and the operations on the merged AST allocate from it so it
+ * needs no lock.
+ */
+static struct arena *webidl_arena;
+
+/**
+ * index of top level definitions by identifier.
+ */
+struct webidl_index {
+        struct hashtable *interfaces; /**< interface definitions */
+        struct hashtable *dictionaries; /**< dictionary definitions */
+};
+
+/**
+ * state of a single web idl file parse.
  */
-static FILE *webidl_parsetracef;
+struct webidl_parse {
+        char *filename; /**< IDL filename from the binding */
+        FILE *file; /**< open IDL file or NULL once parsed */
+        struct webidl_node *root; /**< definitions from the file */
+        struct webidl_index index; /**< definitions in this file */
+        struct arena *arena; /**< nodes and text of the file */
+        bool merged; /**< the file was merged and its text interned */
+        FILE *tracef; /**< parser trace log or NULL when not debugging */
+        unsigned int includec; /**< number of files included by the file */
+        char **includev; /**< paths of the files included by the file */
+};
+
+/**
+ * index of the definitions in the AST.
+ */
+static struct webidl_index webidl_definitions;
+
+/**
+ * paths of the files included by the files merged into the AST.
+ */
+static unsigned int webidl_includec;
+static const char **webidl_includev;
+
+/**
+ * index of the node lists by type while the AST is not being altered.
+ */
+static struct nodeindex *webidl_nodeindex;
 
 extern int webidl_debug;
-extern int webidl__flex_debug;
-extern void webidl_restart(FILE*);
-extern int webidl_parse(struct webidl_node **webidl_ast);
+extern int webidl_lex_init_extra(struct webidl_parse *parse, void **scanner);
+extern int webidl_lex_destroy(void *scanner);
+extern void webidl_set_in(FILE *in, void *scanner);
+extern void webidl_set_debug(int debug, void *scanner);
+extern int webidl_parse(void *scanner, struct webidl_parse *parse);
 
 struct webidl_node {
 	enum webidl_node_type type; /* the type of the node */
@@ -119,14 +172,114 @@ webidl_node_add(struct webidl_node *node, struct webidl_node *list)
 }
 
 
-struct webidl_node *
+/**
+ * get the arena to allocate from
+ *
+ * A file being parsed has an arena of its own so concurrent parses do
+ * not contend, everything else is allocated from the merged AST arena
+ * which is created if necessary.
+ */
+static struct arena *webidl_get_arena(struct webidl_parse *parse)
+{
+        if (parse != NULL) {
+                return parse->arena;
+        }
+        if (webidl_arena == NULL) {
+                webidl_arena = arena_new();
+                if (webidl_arena == NULL) {
+                        fprintf(stderr, "Error: out of memory\n");
+                        exit(EXIT_FAILURE);
+                }
+        }
+        return webidl_arena;
+}
+
+/**
+ * allocate zeroed memory owned by the AST
+ */
+static void *webidl_alloc(struct webidl_parse *parse, size_t size)
+{
+        void *res;
+
+        res = arena_alloc(webidl_get_arena(parse), size);
+        if (res == NULL) {
+                fprintf(stderr, "Error: out of memory\n");
+                exit(EXIT_FAILURE);
+        }
+        return res;
+}
+
 /* exported interface documented in webidl-ast.h */
-webidl_node_new(enum webidl_node_type type,
+char *webidl_strndup(struct webidl_parse *parse, const char *s, size_t n)
+{
+        char *res;
+
+        res = arena_strndup(webidl_get_arena(parse), s, n);
+        if (res == NULL) {
+                fprintf(stderr, "Error: out of memory\n");
+                exit(EXIT_FAILURE);
+        }
+        return res;
+}
+
+/* exported interface documented in webidl-ast.h */
+char *webidl_strdup(struct webidl_parse *parse, const char *s)
+{
+        return webidl_strndup(parse, s, strlen(s));
+}
+
+/* exported interface documented in webidl-ast.h */
+void webidl_ast_reset(void)
+{
+        hashtable_free(webidl_definitions.interfaces);
+        webidl_definitions.interfaces = NULL;
+        hashtable_free(webidl_definitions.dictionaries);
+        webidl_definitions.dictionaries = NULL;
+        nodeindex_free(webidl_nodeindex);
+        webidl_nodeindex = NULL;
+        free(webidl_includev);
+        webidl_includev = NULL;
+        webidl_includec = 0;
+
+        arena_free(webidl_arena);
+        webidl_arena = NULL;
+}
+
+/* exported interface documented in webidl-ast.h */
+unsigned int webidl_ast_includes(const char ***includev_out)
+{
+        *includev_out = webidl_includev;
+        return webidl_includec;
+}
+
+static void *webidl_nodeindex_next(void *node)
+{
+        return ((struct webidl_node *)node)->l;
+}
+
+static unsigned int webidl_nodeindex_type(void *node)
+{
+        return ((struct webidl_node *)node)->type;
+}
+
+/* exported interface documented in webidl-ast.h */
+void webidl_ast_index(void)
+{
+        if (webidl_nodeindex == NULL) {
+                webidl_nodeindex = nodeindex_new(webidl_nodeindex_next,
+                                                 webidl_nodeindex_type);
+        }
+}
+
+/* exported interface documented in webidl-ast.h */
+struct webidl_node *
+webidl_node_new(struct webidl_parse *parse,
+		enum webidl_node_type type,
 		struct webidl_node *l,
 		void *r)
 {
 	struct webidl_node *nn;
-	nn = calloc(1, sizeof(struct webidl_node));
+	nn = webidl_alloc(parse, sizeof(struct webidl_node));
 	nn->type = type;
 	nn->l = l;
 	nn->r.value = r;
@@ -135,18 +288,35 @@ webidl_node_new(enum webidl_node_type type,
 
 /* exported interface documented in webidl-ast.h */
 struct webidl_node *
-webidl_new_number_node(enum webidl_node_type type,
+webidl_new_number_node(struct webidl_parse *parse,
+                       enum webidl_node_type type,
                        struct webidl_node *l,
                        int number)
 {
 	struct webidl_node *nn;
-	nn = calloc(1, sizeof(struct webidl_node));
+	nn = webidl_alloc(parse, sizeof(struct webidl_node));
 	nn->type = type;
 	nn->l = l;
 	nn->r.number = number;
 	return nn;
 }
 
+/* exported interface documented in webidl-ast.h */
+struct webidl_node *
+webidl_new_float_node(struct webidl_parse *parse,
+                      enum webidl_node_type type,
+                      struct webidl_node *l,
+                      float value)
+{
+	struct webidl_node *nn;
+	nn = webidl_alloc(parse, sizeof(struct webidl_node));
+	nn->type = type;
+	nn->l = l;
+	nn->r.flt = webidl_alloc(parse, sizeof(float));
+	*nn->r.flt = value;
+	return nn;
+}
+
 
 int
 webidl_node_for_each_type(struct webidl_node *node,
@@ -193,6 +363,15 @@ webidl_node_enumerate_type(struct webidl_node *node,
 			    enum webidl_node_type type)
 {
 	int count = 0;
+
+	if ((node != NULL) && (webidl_nodeindex != NULL)) {
+		count = nodeindex_count(webidl_nodeindex, node, type);
+		if (count >= 0) {
+			return count;
+		}
+		count = 0;
+	}
+
 	webidl_node_for_each_type(node,
 				  type,
 				  webidl_enumerate_node,
@@ -234,6 +413,16 @@ webidl_node_find_type(struct webidl_node *node,
 		  struct webidl_node *prev,
 		  enum webidl_node_type type)
 {
+	void *found;
+
+	trace_count(TRACE_COUNTER_FIND_TYPE, 1);
+
+	if ((node != NULL) &&
+	    (webidl_nodeindex != NULL) &&
+	    (nodeindex_find(webidl_nodeindex, node, prev, type, &found) == 0)) {
+		return found;
+	}
+
 	return webidl_node_find(node,
 				prev,
 				webidl_cmp_node_type,
@@ -268,6 +457,116 @@ webidl_node_find_type_ident(struct webidl_node *root_node,
 	return node;
 }
 
+/**
+ * get the index for a type of top level definition
+ *
+ * \param index The definition index.
+ * \param type The type of definition.
+ * \return the hash table or NULL if there is no index for the type
+ */
+static struct hashtable **
+webidl_definition_index(struct webidl_index *index,
+                        enum webidl_node_type type)
+{
+        switch (type) {
+        case WEBIDL_NODE_TYPE_INTERFACE:
+                return &index->interfaces;
+
+        case WEBIDL_NODE_TYPE_DICTIONARY:
+                return &index->dictionaries;
+
+        default:
+                break;
+        }
+        return NULL;
+}
+
+/**
+ * get the identifier of a top level definition
+ */
+static const char *webidl_definition_ident(struct webidl_node *definition)
+{
+        return webidl_node_gettext(
+                webidl_node_find_type(webidl_node_getnode(definition),
+                                      NULL,
+                                      WEBIDL_NODE_TYPE_IDENT));
+}
+
+/**
+ * record a top level definition in the index for its type
+ *
+ * \param index The definition index.
+ * \param definition The definition to index.
+ */
+static void
+webidl_index_definition(struct webidl_index *index,
+                        struct webidl_node *definition)
+{
+        struct hashtable **table;
+        const char *ident;
+
+        table = webidl_definition_index(index, definition->type);
+        if (table != NULL) {
+                ident = webidl_definition_ident(definition);
+                if (ident != NULL) {
+                        if (*table == NULL) {
+                                *table = hashtable_new();
+                        }
+                        if ((*table == NULL) ||
+                            (hashtable_insert(*table,
+                                              ident,
+                                              definition) != 0)) {
+                                fprintf(stderr, "Error: out of memory\n");
+                                exit(EXIT_FAILURE);
+                        }
+                }
+        }
+}
+
+/**
+ * find a top level definition in an index
+ */
+static struct webidl_node *
+webidl_index_find(struct webidl_index *index,
+                  enum webidl_node_type type,
+                  const char *ident)
+{
+        struct hashtable **table;
+
+        table = webidl_definition_index(index, type);
+        if ((table == NULL) || (ident == NULL)) {
+                return NULL;
+        }
+        return hashtable_find(*table, ident);
+}
+
+/* exported interface documented in webidl-ast.h */
+struct webidl_node *
+webidl_node_find_definition(enum webidl_node_type type, const char *ident)
+{
+        return webidl_index_find(&webidl_definitions, type, ident);
+}
+
+/* exported interface documented in webidl-ast.h */
+struct webidl_node *
+webidl_parse_add_definition(struct webidl_parse *parse,
+                            struct webidl_node *definition)
+{
+        if (definition != NULL) {
+                webidl_index_definition(&parse->index, definition);
+                parse->root = webidl_node_prepend(parse->root, definition);
+        }
+        return parse->root;
+}
+
+/* exported interface documented in webidl-ast.h */
+struct webidl_node *
+webidl_parse_find_definition(struct webidl_parse *parse,
+                             enum webidl_node_type type,
+                             const char *ident)
+{
+        return webidl_index_find(&parse->index, type, ident);
+}
 
 /* exported interface defined in webidl-ast.h */
 char *webidl_node_gettext(struct webidl_node *node)
@@ -288,6 +587,346 @@ char *webidl_node_gettext(struct webidl_node *node)
 	return NULL;
 }
 
+/* exported interface defined in webidl-ast.h */
+uint64_t webidl_node_hash(struct webidl_node *node, uint64_t hash)
+{
+	struct webidl_node *child;
+	char *txt;
+	int *val;
+	float *flt;
+
+	if (node == NULL) {
+		return hash;
+	}
+
+	hash = genb_hash(hash, &node->type, sizeof(node->type));
+
+	txt = webidl_node_gettext(node);
+	if (txt != NULL) {
+		return genb_hash(hash, txt, strlen(txt) + 1);
+	}
+
+	val = webidl_node_getint(node);
+	if (val != NULL) {
+		return genb_hash(hash, val, sizeof(*val));
+	}
+
+	flt = webidl_node_getfloat(node);
+	if (flt != NULL) {
+		return genb_hash(hash, flt, sizeof(*flt));
+	}
+
+	child = webidl_node_getnode(node);
+	while (child != NULL) {
+		hash = webidl_node_hash(child, hash);
+		child = child->l;
+	}
+
+	/* mark the end of the children so siblings cannot alias them */
+	return genb_hash(hash, "", 1);
+}
+
+/** magic identifying the binary AST format */
+#define WEBIDL_AST_MAGIC "NSGBIDL1"
+
+/** the kind of value held by a node */
+enum webidl_node_value {
+	WEBIDL_NODE_VALUE_NONE,
+	WEBIDL_NODE_VALUE_NODE,
+	WEBIDL_NODE_VALUE_TEXT,
+	WEBIDL_NODE_VALUE_INT,
+	WEBIDL_NODE_VALUE_FLOAT,
+};
+
+/**
+ * get the kind of value held by nodes of a type
+ *
+ * This must agree with the node contents accessors.
+ */
+static enum webidl_node_value webidl_node_value_kind(enum webidl_node_type type)
+{
+	switch (type) {
+	case WEBIDL_NODE_TYPE_ROOT:
+	case WEBIDL_NODE_TYPE_INTERFACE:
+	case WEBIDL_NODE_TYPE_DICTIONARY:
+	case WEBIDL_NODE_TYPE_LIST:
+	case WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE:
+	case WEBIDL_NODE_TYPE_ATTRIBUTE:
+	case WEBIDL_NODE_TYPE_OPERATION:
+	case WEBIDL_NODE_TYPE_OPTIONAL:
+	case WEBIDL_NODE_TYPE_ARGUMENT:
+	case WEBIDL_NODE_TYPE_TYPE:
+	case WEBIDL_NODE_TYPE_CONST:
+		return WEBIDL_NODE_VALUE_NODE;
+
+	case WEBIDL_NODE_TYPE_IDENT:
+	case WEBIDL_NODE_TYPE_INHERITANCE:
+	case WEBIDL_NODE_TYPE_INTERFACE_IMPLEMENTS:
+	case WEBIDL_NODE_TYPE_LITERAL_STRING:
+		return WEBIDL_NODE_VALUE_TEXT;
+
+	case WEBIDL_NODE_TYPE_MODIFIER:
+	case WEBIDL_NODE_TYPE_TYPE_BASE:
+	case WEBIDL_NODE_TYPE_LITERAL_INT:
+	case WEBIDL_NODE_TYPE_SPECIAL:
+	case WEBIDL_NODE_TYPE_LITERAL_BOOL:
+		return WEBIDL_NODE_VALUE_INT;
+
+	case WEBIDL_NODE_TYPE_LITERAL_FLOAT:
+		return WEBIDL_NODE_VALUE_FLOAT;
+
+	default:
+		break;
+	}
+	return WEBIDL_NODE_VALUE_NONE;
+}
+
+/**
+ * binary AST header
+ *
+ * followed by the node records and then the string table
+ */
+struct webidl_ast_header {
+	char magic[8];
+	uint32_t nodec; /**< number of node records */
+	uint32_t strsize; /**< size of string table */
+};
+
+/**
+ * binary AST node record
+ *
+ * Nodes are numbered in depth first order from one with zero meaning no
+ * node so children and siblings always have a higher number than the
+ * node referring to them.
+ */
+struct webidl_ast_record {
+	uint32_t type; /**< node type */
+	uint32_t next; /**< number of next sibling node */
+	uint32_t value; /**< child node number, string offset or number */
+};
+
+/** state while serialising an AST */
+struct webidl_ast_writer {
+	struct webidl_ast_record *recv;
+	uint32_t recc;
+	uint32_t reca;
+	char *str;
+	uint32_t strsize;
+	uint32_t stralloc;
+};
+
+/**
+ * add a string to the string table
+ *
+ * \return offset of the string in the table
+ */
+static uint32_t
+webidl_ast_write_string(struct webidl_ast_writer *w, const char *txt)
+{
+	uint32_t len = strlen(txt) + 1;
+	uint32_t offset;
+	char *str;
+
+	if ((w->strsize + len) > w->stralloc) {
+		w->stralloc = (w->stralloc + len) * 2;
+		str = realloc(w->str, w->stralloc);
+		if (str == NULL) {
+			fprintf(stderr, "Error: out of memory\n");
+			exit(EXIT_FAILURE);
+		}
+		w->str = str;
+	}
+
+	offset = w->strsize;
+	memcpy(w->str + offset, txt, len);
+	w->strsize += len;
+
+	return offset;
+}
+
+/**
+ * serialise a list of sibling nodes and their children
+ *
+ * \return the number of the first node in the list or 0 if empty
+ */
+static uint32_t
+webidl_ast_write_list(struct webidl_ast_writer *w, struct webidl_node *node)
+{
+	struct webidl_ast_record *recv;
+	uint32_t first = 0;
+	uint32_t prev = 0;
+	uint32_t idx;
+	uint32_t value;
+
+	for (; node != NULL; node = node->l) {
+		if (w->recc == w->reca) {
+			w->reca = (w->reca == 0) ? 1024 : w->reca * 2;
+			recv = realloc(w->recv, w->reca * sizeof(*recv));
+			if (recv == NULL) {
+				fprintf(stderr, "Error: out of memory\n");
+				exit(EXIT_FAILURE);
+			}
+			w->recv = recv;
+		}
+		idx = w->recc++;
+
+		w->recv[idx].type = node->type;
+		w->recv[idx].next = 0;
+		if (prev == 0) {
+			first = idx + 1;
+		} else {
+			w->recv[prev - 1].next = idx + 1;
+		}
+		prev = idx + 1;
+
+		switch (webidl_node_value_kind(node->type)) {
+		case WEBIDL_NODE_VALUE_NODE:
+			value = webidl_ast_write_list(w, node->r.node);
+			break;
+
+		case WEBIDL_NODE_VALUE_TEXT:
+			value = webidl_ast_write_string(w, node->r.text);
+			break;
+
+		case WEBIDL_NODE_VALUE_INT:
+			value = node->r.number;
+			break;
+
+		case WEBIDL_NODE_VALUE_FLOAT:
+			memcpy(&value, node->r.flt, sizeof(value));
+			break;
+
+		default:
+			value = 0;
+			break;
+		}
+		/* the record array may have moved while writing children */
+		w->recv[idx].value = value;
+	}
+
+	return first;
+}
+
+/* exported interface defined in webidl-ast.h */
+int webidl_ast_write(struct webidl_node *node, FILE *outf)
+{
+	struct webidl_ast_writer w;
+	struct webidl_ast_header hdr;
+	int res = 0;
+
+	memset(&w, 0, sizeof(w));
+
+	webidl_ast_write_list(&w, node);
+
+	memcpy(hdr.magic, WEBIDL_AST_MAGIC, sizeof(hdr.magic));
+	hdr.nodec = w.recc;
+	hdr.strsize = w.strsize;
+
+	if ((fwrite(&hdr, sizeof(hdr), 1, outf) != 1) ||
+	    (fwrite(w.recv, sizeof(*w.recv), w.recc, outf) != w.recc) ||
+	    (fwrite(w.str, 1, w.strsize, outf) != w.strsize)) {
+		res = -1;
+	}
+
+	free(w.recv);
+	free(w.str);
+
+	return res;
+}
+
+/* exported interface defined in webidl-ast.h */
+int webidl_ast_read(const void *data, size_t len, struct webidl_node **node_out)
+{
+	const struct webidl_ast_header *hdr = data;
+	const struct webidl_ast_record *recv;
+	const char *str;
+	struct webidl_node *nodev;
+	struct webidl_node *node;
+	uint32_t idx;
+
+	/* check the header and that the records and strings are present */
+	if ((len < sizeof(*hdr)) ||
+	    (memcmp(hdr->magic, WEBIDL_AST_MAGIC, sizeof(hdr->magic)) != 0) ||
+	    (((len - sizeof(*hdr)) / sizeof(*recv)) < hdr->nodec) ||
+	    ((len - sizeof(*hdr) - (hdr->nodec * sizeof(*recv))) !=
+	     hdr->strsize) ||
+	    ((hdr->strsize > 0) &&
+	     (((const char *)data)[len - 1] != 0))) {
+		return -1;
+	}
+	recv = (const struct webidl_ast_record *)(hdr + 1);
+	str = (const char *)(recv + hdr->nodec);
+
+	if (hdr->nodec == 0) {
+		*node_out = NULL;
+		return 0;
+	}
+
+	/* all the nodes are allocated together */
+	nodev = webidl_alloc(NULL, hdr->nodec * sizeof(struct webidl_node));
+
+	for (idx = 0; idx < hdr->nodec; idx++) {
+		const struct webidl_ast_record *rec = recv + idx;
+
+		/* the type indexes per type tables so must be known */
+		if (rec->type > WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE) {
+			return -1;
+		}
+
+		node = nodev + idx;
+		node->type = rec->type;
+
+		/* references must be forward to prevent loops */
+		if (rec->next != 0) {
+			if ((rec->next <= (idx + 1)) ||
+			    (rec->next > hdr->nodec)) {
+				return -1;
+			}
+			node->l = nodev + rec->next - 1;
+		}
+
+		switch (webidl_node_value_kind(rec->type)) {
+		case WEBIDL_NODE_VALUE_NODE:
+			if (rec->value != 0) {
+				if ((rec->value <= (idx + 1)) ||
+				    (rec->value > hdr->nodec)) {
+					return -1;
+				}
+				node->r.node = nodev + rec->value - 1;
+			}
+			break;
+
+		case WEBIDL_NODE_VALUE_TEXT:
+			if (rec->value >= hdr->strsize) {
+				return -1;
+			}
+			node->r.text = intern_string(str + rec->value);
+			break;
+
+		case WEBIDL_NODE_VALUE_INT:
+			node->r.number = rec->value;
+			break;
+
+		case WEBIDL_NODE_VALUE_FLOAT:
+			node->r.flt = webidl_alloc(NULL, sizeof(float));
+			memcpy(node->r.flt, &rec->value, sizeof(float));
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	/* rebuild the index of the top level definitions */
+	for (node = nodev; node != NULL; node = node->l) {
+		webidl_index_definition(&webidl_definitions, node);
+	}
+
+	*node_out = nodev;
+
+	return 0;
+}
+
 /* exported interface defined in webidl-ast.h */
 int *
 webidl_node_getint(struct webidl_node *node)
@@ -589,37 +1228,123 @@ int webidl_dump_ast(struct webidl_node *node)
         return 0;
 }
 
+/**
+ * accumulate the memory used by nodes reachable from a node
+ */
+static void
+webidl_ast_memstats_walk(struct memstats_set *seen,
+			 struct memstats_entry *entries,
+			 struct webidl_node *node)
+{
+	struct memstats_entry *entry;
+
+	/* everything reachable from a node already seen has been counted */
+	while ((node != NULL) && memstats_set_add(seen, node)) {
+		entry = &entries[node->type];
+		entry->count++;
+		entry->bytes += sizeof(struct webidl_node);
+
+		switch (webidl_node_value_kind(node->type)) {
+		case WEBIDL_NODE_VALUE_NODE:
+			webidl_ast_memstats_walk(seen, entries, node->r.node);
+			break;
+
+		case WEBIDL_NODE_VALUE_TEXT:
+			if (memstats_set_add(seen, node->r.text)) {
+				entry->value_bytes += strlen(node->r.text) + 1;
+			}
+			break;
+
+		case WEBIDL_NODE_VALUE_FLOAT:
+			if (memstats_set_add(seen, node->r.flt)) {
+				entry->value_bytes += sizeof(float);
+			}
+			break;
+
+		default:
+			break;
+		}
+		node = node->l;
+	}
+}
+
+/* exported interface documented in webidl-ast.h */
+int webidl_ast_memstats(FILE *outf, struct webidl_node *node)
+{
+	struct memstats_entry entries[WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE + 1];
+	struct memstats_entry total = { 0, 0, 0 };
+	struct memstats_set *seen;
+	size_t used;
+	size_t size;
+	int type;
+
+	seen = memstats_set_new();
+	if (seen == NULL) {
+		return -1;
+	}
+
+	memset(entries, 0, sizeof(entries));
+	webidl_ast_memstats_walk(seen, entries, node);
+	memstats_set_free(seen);
+
+	memstats_table_start(outf, "webidl AST");
+	for (type = 0; type <= WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE; type++) {
+		memstats_table_row(outf,
+				   webidl_node_type_to_str(type),
+				   &entries[type]);
+		memstats_entry_add(&total, &entries[type]);
+	}
+	memstats_table_row(outf, "total", &total);
+
+	/* the parsed files own the nodes the merged definitions share */
+	size = arena_usage(webidl_arena, &used);
+	fprintf(outf, "  arena %lu bytes allocated, %lu bytes used\n",
+		(unsigned long)size,
+		(unsigned long)used);
+
+	return 0;
+}
+
 /* exported interface defined in webidl-ast.h */
-static FILE *idlopen(const char *filename)
+char *webidl_file_path(const char *filename)
 {
-	FILE *idlfile;
 	char *fullname;
 	int fulllen;
 
 	if (options->idlpath == NULL) {
-		if (options->verbose) {
-			printf("Opening IDL file %s\n", filename);
-		}
-		return fopen(filename, "r");
+		return strdup(filename);
 	}
 
 	fulllen = strlen(options->idlpath) + strlen(filename) + 2;
 	fullname = malloc(fulllen);
 	snprintf(fullname, fulllen, "%s/%s", options->idlpath, filename);
+
+	return fullname;
+}
+
+static FILE *idlopen(const char *filename)
+{
+	FILE *idlfile;
+	char *fullname;
+
+	fullname = webidl_file_path(filename);
 	if (options->verbose) {
 		printf("Opening IDL file %s\n", fullname);
 	}
 	idlfile = fopen(fullname, "r");
+	if (idlfile != NULL) {
+		depfile_add(fullname);
+	}
 	free(fullname);
 
 	return idlfile;
 }
 
 /* exported interface defined in webidl-ast.h */
-int webidl_parsefile(char *filename, struct webidl_node **webidl_ast)
+int webidl_parse_new(const char *filename, struct webidl_parse **parse_out)
 {
+	struct webidl_parse *parse;
 	FILE *idlfile;
-        int ret;
 
 	idlfile = idlopen(filename);
 	if (!idlfile) {
@@ -629,47 +1354,289 @@ int webidl_parsefile(char *filename, struct webidl_node **webidl_ast)
 		return 2;
 	}
 
+	parse = calloc(1, sizeof(struct webidl_parse));
+	if (parse == NULL) {
+		fclose(idlfile);
+		fprintf(stderr, "Error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+	parse->filename = strdup(filename);
+	parse->file = idlfile;
+
+	/* the parser trace flag is global so is only set from one thread */
+	webidl_debug = options->debug ? 1 : 0;
+
+	parse->arena = arena_new();
+	if (parse->arena == NULL) {
+		fprintf(stderr, "Error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	*parse_out = parse;
+
+	return 0;
+}
+
+/* exported interface defined in webidl-ast.h */
+int webidl_parse_run(struct webidl_parse *parse)
+{
+	void *scanner;
+        uint64_t start;
+        int ret;
+
+	start = trace_start();
+
+	if (webidl_lex_init_extra(parse, &scanner) != 0) {
+		fprintf(stderr, "Error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
         /* if debugging enabled enable parser tracing and send to file */
         if (options->debug) {
                 char *tracename;
                 int tracenamelen;
-		webidl_debug = 1;
-		webidl__flex_debug = 1;
+		webidl_set_debug(1, scanner);
 
-                tracenamelen = SLEN("webidl--trace") + strlen(filename) + 1;
+                tracenamelen = SLEN("webidl--trace") +
+                        strlen(parse->filename) + 1;
                 tracename = malloc(tracenamelen);
-                snprintf(tracename, tracenamelen,"webidl-%s-trace", filename);
-                webidl_parsetracef = genb_fopen(tracename, "w");
+                snprintf(tracename, tracenamelen,
+                         "webidl-%s-trace", parse->filename);
+                parse->tracef = genb_fopen(tracename, "w");
                 free(tracename);
-        } else {
-                webidl_parsetracef = NULL;
         }
 
 	/* set flex to read from file */
-	webidl_restart(idlfile);
+	webidl_set_in(parse->file, scanner);
 
 	/* parse the file */
-	ret = webidl_parse(webidl_ast);
+	ret = webidl_parse(scanner, parse);
+
+	webidl_lex_destroy(scanner);
+	fclose(parse->file);
+	parse->file = NULL;
 
         /* close tracefile if open */
-        if (webidl_parsetracef != NULL) {
-                fclose(webidl_parsetracef);
+        if (parse->tracef != NULL) {
+                fclose(parse->tracef);
+                parse->tracef = NULL;
         }
+
+        trace_end(start, "webidl_parse", parse->filename);
+
         return ret;
 }
 
+/**
+ * copy a top level definition and its direct members
+ *
+ * Merging and intercalating implements only alter the links between a
+ * definition and its direct members so the deeper nodes are shared
+ * with the parsed file.
+ */
+static struct webidl_node *
+webidl_definition_copy(struct webidl_node *definition)
+{
+	struct webidl_node *copy;
+	struct webidl_node *member;
+	struct webidl_node **tail;
+
+	copy = webidl_node_new(NULL,
+			       definition->type,
+			       NULL,
+			       definition->r.value);
+
+	member = webidl_node_getnode(definition);
+	if (member != NULL) {
+		tail = &copy->r.node;
+		while (member != NULL) {
+			*tail = webidl_node_new(NULL,
+						member->type,
+						NULL,
+						member->r.value);
+			tail = &(*tail)->l;
+			member = member->l;
+		}
+	}
+
+	return copy;
+}
+
+/**
+ * merge the members of a definition into an existing one
+ *
+ * The members are prepended exactly as a partial definition parsed
+ * after the existing one would have added them. The identifier and
+ * extended attributes belong to the node which created the definition
+ * so are dropped.
+ */
+static void
+webidl_merge_definition(struct webidl_node *existing,
+			struct webidl_node *definition)
+{
+	struct webidl_node *members = NULL;
+	struct webidl_node **tail = &members;
+	struct webidl_node *member;
+	struct webidl_node *next;
+
+	for (member = definition->r.node; member != NULL; member = next) {
+		next = member->l;
+		if ((member->type != WEBIDL_NODE_TYPE_IDENT) &&
+		    (member->type != WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE)) {
+			member->l = NULL;
+			*tail = member;
+			tail = &member->l;
+		}
+	}
+
+	webidl_node_add(existing, members);
+}
+
+/**
+ * intern the text of a list of nodes and all their children
+ *
+ * The parsers only copy their text so they need not share the symbol
+ * table, it is interned here so identifiers from every file and the
+ * binding may be compared by pointer.
+ */
+static void webidl_intern_text(struct webidl_node *node)
+{
+	while (node != NULL) {
+		if (webidl_node_gettext(node) != NULL) {
+			node->r.text = intern_string(node->r.text);
+		} else {
+			webidl_intern_text(webidl_node_getnode(node));
+		}
+		node = node->l;
+	}
+}
+
 /* exported interface defined in webidl-ast.h */
-int webidl_fprintf(FILE *stream, const char *format, ...)
+void webidl_parse_merge(struct webidl_parse *parse,
+			struct webidl_node **webidl_ast)
+{
+	struct webidl_node *definitions = NULL;
+	struct webidl_node *definition;
+	struct webidl_node *existing;
+	struct webidl_node *next;
+	const char **includev;
+	unsigned int idx;
+
+	/* dependencies are recorded here as the parse ran on a worker */
+	if (parse->includec > 0) {
+		includev = realloc(webidl_includev,
+				   (webidl_includec + parse->includec) *
+				   sizeof(const char *));
+		if (includev == NULL) {
+			fprintf(stderr, "Error: out of memory\n");
+			exit(EXIT_FAILURE);
+		}
+		webidl_includev = includev;
+	}
+	for (idx = 0; idx < parse->includec; idx++) {
+		depfile_add(parse->includev[idx]);
+		webidl_includev[webidl_includec++] = parse->includev[idx];
+	}
+
+	/* the first merge of a file interns its text */
+	if (!parse->merged) {
+		webidl_intern_text(parse->root);
+		parse->merged = true;
+	}
+
+	/* the root list is built by prepending so copying while walking
+	 * it puts the definitions back in the order they appear in the
+	 * file
+	 */
+	for (definition = parse->root;
+	     definition != NULL;
+	     definition = definition->l) {
+		next = webidl_definition_copy(definition);
+		next->l = definitions;
+		definitions = next;
+	}
+
+	for (definition = definitions; definition != NULL; definition = next) {
+		next = definition->l;
+		definition->l = NULL;
+
+		existing = webidl_index_find(&webidl_definitions,
+					     definition->type,
+					     webidl_definition_ident(definition));
+		if (existing != NULL) {
+			webidl_merge_definition(existing, definition);
+		} else {
+			webidl_index_definition(&webidl_definitions,
+						definition);
+			*webidl_ast = webidl_node_prepend(*webidl_ast,
+							  definition);
+		}
+	}
+}
+
+/* exported interface defined in webidl-ast.h */
+void webidl_parse_free(struct webidl_parse *parse)
+{
+	unsigned int idx;
+
+	if (parse == NULL) {
+		return;
+	}
+	if (parse->file != NULL) {
+		fclose(parse->file);
+	}
+	hashtable_free(parse->index.interfaces);
+	hashtable_free(parse->index.dictionaries);
+	arena_free(parse->arena);
+	for (idx = 0; idx < parse->includec; idx++) {
+		free(parse->includev[idx]);
+	}
+	free(parse->includev);
+	free(parse->filename);
+	free(parse);
+}
+
+/* exported interface defined in webidl-ast.h */
+void webidl_parse_include(struct webidl_parse *parse, const char *filename)
+{
+	char **includev;
+
+	includev = realloc(parse->includev,
+			   (parse->includec + 1) * sizeof(char *));
+	if (includev == NULL) {
+		fprintf(stderr, "Error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+	parse->includev = includev;
+
+	parse->includev[parse->includec] = strdup(filename);
+	if (parse->includev[parse->includec] == NULL) {
+		fprintf(stderr, "Error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+	parse->includec++;
+}
+
+/* exported interface defined in webidl-ast.h */
+int webidl_fprintf(struct webidl_parse *parse,
+                   FILE *stream,
+                   const char *format,
+                   ...)
 {
         va_list ap;
         int ret;
 
+        if (parse == NULL) {
+                /* cannot tell which file the output belongs to */
+                return 0;
+        }
+
         va_start(ap, format);
 
-        if (webidl_parsetracef == NULL) {
+        if (parse->tracef == NULL) {
                 ret = vfprintf(stream, format, ap);
         } else {
-                ret = vfprintf(webidl_parsetracef, format, ap);
+                ret = vfprintf(parse->tracef, format, ap);
         }
         va_end(ap);
 
@@ -719,7 +1686,7 @@ static int implements_copy_nodes(struct webidl_node *src_node,
 	while (src != NULL) {
 		if (src->type == WEBIDL_NODE_TYPE_LIST) {
 			/** @todo technicaly this should copy WEBIDL_NODE_TYPE_INHERITANCE */
-			dst = webidl_node_new(src->type, dst, src->r.text);
+			dst = webidl_node_new(NULL, src->type, dst, src->r.text);
 		}
 		src = src->l;
 	}
@@ -729,12 +1696,51 @@ static int implements_copy_nodes(struct webidl_node *src_node,
 	return 0;
 }
 
+/** interface whose implements are being intercalated */
+static const int intercalate_active;
+
+/** interface whose implements have been intercalated */
+static const int intercalate_done;
+
 static int
 intercalate_implements(struct webidl_node *interface_node, void *ctx)
 {
+	struct hashtable *state = ctx;
 	struct webidl_node *implements_node;
 	struct webidl_node *implements_interface_node;
-	struct webidl_node *webidl_ast = ctx;
+	const char *ident;
+	const void *interface_state = NULL;
+	int res;
+
+	ident = webidl_node_gettext(
+		webidl_node_find_type(webidl_node_getnode(interface_node),
+				      NULL,
+				      WEBIDL_NODE_TYPE_IDENT));
+
+	/* only the definition an identifier refers to is memoized */
+	if ((ident != NULL) &&
+	    (webidl_node_find_definition(WEBIDL_NODE_TYPE_INTERFACE,
+					 ident) != interface_node)) {
+		ident = NULL;
+	}
+
+	if (ident != NULL) {
+		interface_state = hashtable_find(state, ident);
+		if (interface_state == &intercalate_done) {
+			return 0;
+		}
+		if (interface_state == &intercalate_active) {
+			fprintf(stderr,
+				"Error: interface %s is part of an implements cycle\n",
+				ident);
+			return -1;
+		}
+		if (hashtable_insert(state,
+				     ident,
+				     (void *)&intercalate_active) != 0) {
+			return -1;
+		}
+	}
 
 	implements_node = webidl_node_find_type(
 		webidl_node_getnode(interface_node),
@@ -742,16 +1748,27 @@ intercalate_implements(struct webidl_node *interface_node, void *ctx)
 		WEBIDL_NODE_TYPE_INTERFACE_IMPLEMENTS);
 	while (implements_node != NULL) {
 
-		implements_interface_node = webidl_node_find_type_ident(
-			webidl_ast,
+		implements_interface_node = webidl_node_find_definition(
 			WEBIDL_NODE_TYPE_INTERFACE,
 			webidl_node_gettext(implements_node));
 
 		/* recurse, ensuring all subordinate interfaces have
 		 * their implements intercalated first
 		 */
-		intercalate_implements(implements_interface_node, webidl_ast);
+		if (implements_interface_node != NULL) {
+			res = intercalate_implements(implements_interface_node,
+						     ctx);
+			if (res != 0) {
+				if (ident != NULL) {
+					fprintf(stderr,
+						"  implemented by %s\n",
+						ident);
+				}
+				return res;
+			}
+		}
 
+		/* the member lists are shared rather than copied */
 		implements_copy_nodes(implements_interface_node, interface_node);
 
 		/* once we have copied the implemntation remove entry */
@@ -762,24 +1779,42 @@ intercalate_implements(struct webidl_node *interface_node, void *ctx)
 			implements_node,
 			WEBIDL_NODE_TYPE_INTERFACE_IMPLEMENTS);
 	}
+
+	if ((ident != NULL) &&
+	    (hashtable_insert(state, ident, (void *)&intercalate_done) != 0)) {
+		return -1;
+	}
+
 	return 0;
 }
 
 /* exported interface defined in webidl-ast.h */
 int webidl_intercalate_implements(struct webidl_node *webidl_ast)
 {
+        struct hashtable *state;
         int res = 0;
+
         if (webidl_ast != NULL) {
+                /* state of each interface so every one is processed
+                 * once and cycles are found
+                 */
+                state = hashtable_new();
+                if (state == NULL) {
+                        return -1;
+                }
+
                 /* for each interface:
                  *   for each implements entry:
                  *     find interface from implemets
-                 *     recusrse into that interface
+                 *     recusrse into that interface unless it is done
                  *     copy the interface into this one
                  */
                 res = webidl_node_for_each_type(webidl_ast,
                                                 WEBIDL_NODE_TYPE_INTERFACE,
                                                 intercalate_implements,
-                                                webidl_ast);
+                                                state);
+
+                hashtable_free(state);
         }
         return res;
 }
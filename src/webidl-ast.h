@@ -9,6 +9,8 @@
 #ifndef nsgenbind_webidl_ast_h
 #define nsgenbind_webidl_ast_h
 
+#include <stdint.h>
+
 enum webidl_node_type {
 	/* generic node types which define structure or attributes */
 	WEBIDL_NODE_TYPE_ROOT = 0,
@@ -92,15 +94,83 @@ typedef int (webidl_callback_t)(struct webidl_node *node, void *ctx);
 
 int webidl_cmp_node_type(struct webidl_node *node, void *ctx);
 
+struct webidl_parse;
+
 /**
  * create a new node with a pointer value
+ *
+ * \param parse The file being parsed or NULL for the merged AST.
  */
-struct webidl_node *webidl_node_new(enum webidl_node_type, struct webidl_node *l, void *r);
+struct webidl_node *webidl_node_new(struct webidl_parse *parse, enum webidl_node_type, struct webidl_node *l, void *r);
 
 /**
  * create a new node with an integer value
+ *
+ * \param parse The file being parsed or NULL for the merged AST.
+ */
+struct webidl_node *webidl_new_number_node(struct webidl_parse *parse, enum webidl_node_type type, struct webidl_node *l, int number);
+
+/**
+ * create a new node with a floating point value
+ *
+ * \param parse The file being parsed or NULL for the merged AST.
+ */
+struct webidl_node *webidl_new_float_node(struct webidl_parse *parse, enum webidl_node_type type, struct webidl_node *l, float value);
+
+/**
+ * duplicate a string into storage owned by the AST
+ *
+ * Each file being parsed allocates its nodes and text from an arena of
+ * its own so concurrent parses share no lock. The arena is released
+ * with the parse state so the file may be merged into the AST of
+ * several bindings. Everything else is allocated from the arena of
+ * the merged AST which is released by webidl_ast_reset()
+ *
+ * \param parse The file being parsed or NULL for the merged AST.
+ * \param s The string to duplicate.
+ */
+char *webidl_strdup(struct webidl_parse *parse, const char *s);
+
+/**
+ * duplicate at most n characters of a string into storage owned by the AST
+ *
+ * \param parse The file being parsed or NULL for the merged AST.
+ */
+char *webidl_strndup(struct webidl_parse *parse, const char *s, size_t n);
+
+/**
+ * release the merged Web IDL AST
+ *
+ * The definitions, indexes and the nodes and text allocated for the
+ * merged AST are released in one operation. The nodes of the parsed
+ * files stay allocated until their parse state is released so they
+ * may be merged again to build the AST of another binding.
+ *
+ * No reference to the merged AST may be used afterwards.
+ */
+void webidl_ast_reset(void);
+
+/**
+ * index the node lists of the Web IDL AST by node type
+ *
+ * Typed queries of lists which are queried repeatedly then only visit
+ * the matching nodes. The AST must not be altered until the index is
+ * released by webidl_ast_reset(). Lists are indexed as they are queried
+ * so the AST must only be queried by a single thread.
+ */
+void webidl_ast_index(void);
+
+/**
+ * get the files included by the files merged into the AST
+ *
+ * The paths remain valid until the AST is released by
+ * webidl_ast_reset().
+ *
+ * \param includev_out Updated with the paths in the order they were
+ *                     included.
+ * \return the number of included files
  */
-struct webidl_node *webidl_new_number_node(enum webidl_node_type type, struct webidl_node *l, int number);
+unsigned int webidl_ast_includes(const char ***includev_out);
 
 
 struct webidl_node *webidl_node_prepend(struct webidl_node *list, struct webidl_node *node);
@@ -116,6 +186,18 @@ float *webidl_node_getfloat(struct webidl_node *node);
 
 enum webidl_node_type webidl_node_gettype(struct webidl_node *node);
 
+/**
+ * hash a node and all of its children
+ *
+ * The hash covers the type and value of every node in the subtree so
+ * any change to the IDL a node was built from changes the result.
+ *
+ * \param node The node to hash, siblings of the node are not included.
+ * \param hash The hash to accumulate into.
+ * \return the updated hash
+ */
+uint64_t webidl_node_hash(struct webidl_node *node, uint64_t hash);
+
 /* node searches */
 
 /**
@@ -148,18 +230,159 @@ webidl_node_find_type_ident(struct webidl_node *root_node,
 			    enum webidl_node_type type, 
 			    const char *ident);
 
+/**
+ * find a top level interface or dictionary by identifier
+ *
+ * \param type The type of definition, either WEBIDL_NODE_TYPE_INTERFACE
+ *             or WEBIDL_NODE_TYPE_DICTIONARY.
+ * \param ident The identifier of the definition.
+ * \return The definition node or NULL if not found.
+ */
+struct webidl_node *
+webidl_node_find_definition(enum webidl_node_type type, const char *ident);
 
+/**
+ * state of a single web idl file parse
+ *
+ * Each parse has its own scanner, root list, definition index and
+ * arena so several files may be parsed concurrently.
+ */
+struct webidl_parse;
 
 /**
- * parse web idl file into Abstract Syntax Tree
+ * open a web idl file ready for parsing
+ *
+ * The file is located on the IDL path and recorded as a dependency so
+ * this must be called from a single thread.
+ *
+ * \param filename The IDL filename from the binding.
+ * \param parse_out The new parse state.
+ * \return 0 on success or 2 if the file could not be opened
  */
-int webidl_parsefile(char *filename, struct webidl_node **webidl_ast);
+int webidl_parse_new(const char *filename, struct webidl_parse **parse_out);
+
+/**
+ * parse an opened web idl file
+ *
+ * Files may be parsed concurrently on different threads. When
+ * debugging each parse writes its trace to a file of its own.
+ *
+ * \param parse The parse state from webidl_parse_new()
+ * \return 0 on success else the parser error code
+ */
+int webidl_parse_run(struct webidl_parse *parse);
+
+/**
+ * merge the definitions from a parsed file into the AST
+ *
+ * Files must be merged in the order they are listed in the binding.
+ * Definitions of interfaces and dictionaries which already exist in
+ * the AST are added to the existing node exactly as if the file had
+ * been parsed after the earlier ones.
+ *
+ * The parsed definitions are copied rather than altered so a file may
+ * be merged into the AST of several bindings. The first merge interns
+ * the text of the file and the files it included are recorded as
+ * dependencies so it must be called from a single thread.
+ *
+ * \param parse The parse state after a successful webidl_parse_run()
+ * \param webidl_ast The root of the AST to merge into.
+ */
+void webidl_parse_merge(struct webidl_parse *parse,
+                        struct webidl_node **webidl_ast);
+
+/**
+ * release a parse state
+ */
+void webidl_parse_free(struct webidl_parse *parse);
+
+/**
+ * add a definition to the root list of a file being parsed
+ *
+ * Interface and dictionary definitions are recorded in an index by
+ * their identifier so they can be found without scanning the root list.
+ *
+ * \param parse The parse state.
+ * \param definition The definition to add.
+ * \return The new root of the file's definitions.
+ */
+struct webidl_node *
+webidl_parse_add_definition(struct webidl_parse *parse,
+                            struct webidl_node *definition);
+
+/**
+ * find an interface or dictionary defined in a file being parsed
+ *
+ * \param parse The parse state.
+ * \param type The type of definition.
+ * \param ident The identifier of the definition.
+ * \return The definition node or NULL if not found.
+ */
+struct webidl_node *
+webidl_parse_find_definition(struct webidl_parse *parse,
+                             enum webidl_node_type type,
+                             const char *ident);
+
+/**
+ * record a file included by a file being parsed
+ *
+ * Only the parse state is altered so this may be called while other
+ * files are parsed concurrently.
+ *
+ * \param parse The parse state.
+ * \param filename The path the included file was opened with.
+ */
+void webidl_parse_include(struct webidl_parse *parse, const char *filename);
+
+/**
+ * get the path a web idl file is read from
+ *
+ * \param filename The IDL filename from the binding.
+ * \return The path allowing for the IDL search path, caller must free.
+ */
+char *webidl_file_path(const char *filename);
+
+/**
+ * write an AST in a compact binary form
+ *
+ * \param node The first node of the AST root list.
+ * \param outf The stream to write to.
+ * \return 0 on success else -1
+ */
+int webidl_ast_write(struct webidl_node *node, FILE *outf);
+
+/**
+ * read an AST from its binary form
+ *
+ * The nodes are rebuilt in the AST arena with their text interned and
+ * the top level definitions indexed so the result is equivalent to
+ * parsing the original IDL. The data is not referenced afterwards.
+ *
+ * \param data The binary AST as written by webidl_ast_write()
+ * \param len The length of the data.
+ * \param node_out Updated with the first node of the AST root list.
+ * \return 0 on success or -1 if the data is not a valid binary AST
+ */
+int webidl_ast_read(const void *data, size_t len, struct webidl_node **node_out);
 
 /**
  * dump AST to file
  */
 int webidl_dump_ast(struct webidl_node *node);
 
+/**
+ * write the memory used by an AST
+ *
+ * Reports the count and bytes of nodes of each type reachable from the
+ * node along with the bytes of their values. Nodes and text reachable
+ * by more than one route are only counted once.
+ *
+ * \param outf The file to write the report to.
+ * \param node The node to start from (usually tree root)
+ * \return 0 on success or -1 on memory exhaustion
+ */
+int webidl_ast_memstats(FILE *outf, struct webidl_node *node);
+
 /**
  * perform replacement of implements elements with copies of ast data
  */
@@ -167,8 +390,18 @@ int webidl_intercalate_implements(struct webidl_node *node);
 
 /**
  * formatted printf to allow webidl trace data to be written to file.
+ *
+ * Each parse writes its trace to a file of its own so files may be
+ * parsed concurrently while debugging.
+ *
+ * \param parse The parse being traced, output without one is dropped.
+ * \param stream The stream to use when the parse has no trace file.
+ * \param format The printf format of the output.
  */
-int webidl_fprintf(FILE *stream, const char *format, ...);
+int webidl_fprintf(struct webidl_parse *parse,
+                   FILE *stream,
+                   const char *format,
+                   ...);
 
 /**
  * get string of argument type
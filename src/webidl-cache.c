@@ -0,0 +1,348 @@
+/* Web IDL AST cache implementation
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "options.h"
+#include "utils.h"
+#include "depfile.h"
+#include "nsgenbind-ast.h"
+#include "webidl-ast.h"
+#include "webidl-cache.h"
+
+#ifndef NSGENBIND_VERSION
+#define NSGENBIND_VERSION "unknown"
+#endif
+
+/**
+ * map a whole file into memory
+ *
+ * \param path The file to map.
+ * \param len_out Updated with the length of the file.
+ * \return the mapping, NULL for an empty file or MAP_FAILED on error
+ */
+static void *webidl_cache_map(const char *path, size_t *len_out)
+{
+        struct stat st;
+        void *map;
+        int fd;
+
+        fd = open(path, O_RDONLY);
+        if (fd == -1) {
+                return MAP_FAILED;
+        }
+
+        if (fstat(fd, &st) != 0) {
+                close(fd);
+                return MAP_FAILED;
+        }
+
+        *len_out = st.st_size;
+        if (st.st_size == 0) {
+                close(fd);
+                return NULL;
+        }
+
+        map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        return map;
+}
+
+/** identifies a cache entry and its layout */
+#define WEBIDL_CACHE_MAGIC "NSGBIDC1"
+
+/**
+ * header of a cache entry
+ *
+ * The header is followed by the paths of the files included by the
+ * IDL files, each NUL terminated and padded so the binary AST which
+ * follows is aligned. The included files are only known once the IDL
+ * is parsed so they are checked when the entry is loaded instead of
+ * forming part of the key.
+ */
+struct webidl_cache_header {
+        char magic[8];
+        uint64_t includehash; /**< hash of the included files */
+        uint32_t includec; /**< number of included file paths */
+        uint32_t includesize; /**< size of the paths with padding */
+};
+
+/**
+ * add the name and contents of an input file to a hash
+ *
+ * \param path The path to read the file from.
+ * \param name The name of the file to hash.
+ * \param hash The hash to update.
+ * \return 0 on success or -1 if the file could not be read
+ */
+static int
+webidl_cache_hash_file(const char *path, const char *name, uint64_t *hash)
+{
+        void *map;
+        size_t len;
+
+        map = webidl_cache_map(path, &len);
+        if (map == MAP_FAILED) {
+                return -1;
+        }
+
+        /* the file is an input even if its AST comes from the cache */
+        depfile_add(path);
+
+        *hash = genb_hash(*hash, name, strlen(name) + 1);
+        *hash = genb_hash(*hash, &len, sizeof(len));
+        if (map != NULL) {
+                *hash = genb_hash(*hash, map, len);
+                munmap(map, len);
+        }
+
+        return 0;
+}
+
+/**
+ * add the name and contents of an IDL file to the key
+ */
+static int webidl_cache_key_cb(struct genbind_node *node, void *ctx)
+{
+        const char *filename;
+        char *path;
+        int res;
+
+        filename = genbind_node_gettext(node);
+        path = webidl_file_path(filename);
+
+        res = webidl_cache_hash_file(path, filename, ctx);
+        free(path);
+
+        return res;
+}
+
+/* exported interface documented in webidl-cache.h */
+int webidl_cache_key(struct genbind_node *binding_node, uint64_t *key_out)
+{
+        uint64_t hash;
+        int res;
+
+        hash = genb_hash(GENB_HASH_INIT,
+                         NSGENBIND_VERSION,
+                         SLEN(NSGENBIND_VERSION));
+
+        res = genbind_node_foreach_type(genbind_node_getnode(binding_node),
+                                        GENBIND_NODE_TYPE_WEBIDL,
+                                        webidl_cache_key_cb,
+                                        &hash);
+        if (res != 0) {
+                return -1;
+        }
+
+        *key_out = hash;
+
+        return 0;
+}
+
+/**
+ * get the path of the cache entry for a key
+ *
+ * \param key The cache key.
+ * \param suffix Additional suffix for the path.
+ * \return the path, caller must free
+ */
+static char *webidl_cache_path(uint64_t key, const char *suffix)
+{
+        char *path;
+        int pathl;
+
+        pathl = snprintf(NULL, 0, "%s/%016" PRIx64 ".idlcache%s",
+                         options->cachedir, key, suffix) + 1;
+        path = malloc(pathl);
+        snprintf(path, pathl, "%s/%016" PRIx64 ".idlcache%s",
+                 options->cachedir, key, suffix);
+
+        return path;
+}
+
+/* exported interface documented in webidl-cache.h */
+int webidl_cache_load(uint64_t key, struct webidl_node **webidl_out)
+{
+        const struct webidl_cache_header *hdr;
+        const char *include;
+        const char *includeend;
+        uint64_t includehash = GENB_HASH_INIT;
+        uint32_t idx;
+        char *path;
+        void *map;
+        size_t len = 0;
+        int res = 0;
+
+        path = webidl_cache_path(key, "");
+
+        map = webidl_cache_map(path, &len);
+        if ((map == MAP_FAILED) || (map == NULL)) {
+                free(path);
+                return -1;
+        }
+        hdr = map;
+
+        /* check the header and that the included paths are present */
+        if ((len < sizeof(*hdr)) ||
+            (memcmp(hdr->magic, WEBIDL_CACHE_MAGIC, sizeof(hdr->magic)) != 0) ||
+            ((hdr->includesize % sizeof(uint64_t)) != 0) ||
+            ((len - sizeof(*hdr)) < hdr->includesize)) {
+                res = -1;
+        }
+
+        /* an included file which changed makes the entry stale */
+        if (res == 0) {
+                include = (const char *)(hdr + 1);
+                includeend = include + hdr->includesize;
+                for (idx = 0; idx < hdr->includec; idx++) {
+                        if ((include >= includeend) ||
+                            (memchr(include,
+                                    0,
+                                    includeend - include) == NULL) ||
+                            (webidl_cache_hash_file(include,
+                                                    include,
+                                                    &includehash) != 0)) {
+                                res = -1;
+                                break;
+                        }
+                        include += strlen(include) + 1;
+                }
+                if (includehash != hdr->includehash) {
+                        res = -1;
+                }
+        }
+
+        if (res == 0) {
+                res = webidl_ast_read((const char *)(hdr + 1) +
+                                      hdr->includesize,
+                                      len - sizeof(*hdr) - hdr->includesize,
+                                      webidl_out);
+        }
+        munmap(map, len);
+
+        if (options->verbose) {
+                if (res == 0) {
+                        printf("Loaded IDL from cache %s\n", path);
+                } else {
+                        printf("Ignoring stale or invalid IDL cache %s\n",
+                               path);
+                }
+        }
+        free(path);
+
+        return res;
+}
+
+/**
+ * write the header and included file paths of a cache entry
+ *
+ * \param cachef The stream to write to.
+ * \return 0 on success else -1
+ */
+static int webidl_cache_write_header(FILE *cachef)
+{
+        struct webidl_cache_header hdr;
+        const char **includev;
+        static const char pad[sizeof(uint64_t)];
+        uint32_t idx;
+        size_t len;
+
+        memset(&hdr, 0, sizeof(hdr));
+        memcpy(hdr.magic, WEBIDL_CACHE_MAGIC, sizeof(hdr.magic));
+        hdr.includehash = GENB_HASH_INIT;
+        hdr.includec = webidl_ast_includes(&includev);
+        for (idx = 0; idx < hdr.includec; idx++) {
+                if (webidl_cache_hash_file(includev[idx],
+                                           includev[idx],
+                                           &hdr.includehash) != 0) {
+                        return -1;
+                }
+                hdr.includesize += strlen(includev[idx]) + 1;
+        }
+        len = hdr.includesize;
+        hdr.includesize += (sizeof(pad) - (len % sizeof(pad))) % sizeof(pad);
+
+        if (fwrite(&hdr, sizeof(hdr), 1, cachef) != 1) {
+                return -1;
+        }
+        for (idx = 0; idx < hdr.includec; idx++) {
+                if (fwrite(includev[idx],
+                           strlen(includev[idx]) + 1,
+                           1,
+                           cachef) != 1) {
+                        return -1;
+                }
+        }
+        if (fwrite(pad, 1, hdr.includesize - len, cachef) !=
+            (hdr.includesize - len)) {
+                return -1;
+        }
+
+        return 0;
+}
+
+/* exported interface documented in webidl-cache.h */
+int webidl_cache_store(uint64_t key, struct webidl_node *webidl)
+{
+        char *path;
+        char *tpath;
+        char suffix[16];
+        FILE *cachef;
+        int res;
+
+        path = webidl_cache_path(key, "");
+
+        /* write to a temporary file so readers never see a partial entry */
+        snprintf(suffix, sizeof(suffix), ".%d", (int)getpid());
+        tpath = webidl_cache_path(key, suffix);
+
+        cachef = fopen(tpath, "w");
+        if (cachef == NULL) {
+                fprintf(stderr, "Error: unable to open file %s (%s)\n",
+                        tpath, strerror(errno));
+                free(tpath);
+                free(path);
+                return -1;
+        }
+
+        res = webidl_cache_write_header(cachef);
+        if (res == 0) {
+                res = webidl_ast_write(webidl, cachef);
+        }
+        if (fclose(cachef) != 0) {
+                res = -1;
+        }
+
+        if ((res == 0) && (rename(tpath, path) != 0)) {
+                res = -1;
+        }
+
+        if (res != 0) {
+                fprintf(stderr, "Error: unable to write file %s (%s)\n",
+                        path, strerror(errno));
+                remove(tpath);
+        } else if (options->verbose) {
+                printf("Stored IDL in cache %s\n", path);
+        }
+
+        free(tpath);
+        free(path);
+
+        return res;
+}
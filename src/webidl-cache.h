@@ -0,0 +1,54 @@
+/* Web IDL AST cache
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ */
+
+#ifndef nsgenbind_webidl_cache_h
+#define nsgenbind_webidl_cache_h
+
+#include <stdint.h>
+
+struct genbind_node;
+struct webidl_node;
+
+/**
+ * compute the cache key for the Web IDL files of a binding
+ *
+ * The key is a hash of the tool version and the name and contents of
+ * every IDL file, in order, named by the binding. Files included by
+ * the IDL files are checked when an entry is loaded.
+ *
+ * \param binding_node The binding node listing the IDL files.
+ * \param key_out Updated with the key.
+ * \return 0 on success or -1 if an IDL file could not be read
+ */
+int webidl_cache_key(struct genbind_node *binding_node, uint64_t *key_out);
+
+/**
+ * load a parsed Web IDL AST from the cache
+ *
+ * The entry is only used if none of the files included by the IDL
+ * files when it was stored have changed.
+ *
+ * \param key The cache key of the IDL files.
+ * \param webidl_out Updated with the AST root list on success.
+ * \return 0 on success or -1 if there is no valid cache entry
+ */
+int webidl_cache_load(uint64_t key, struct webidl_node **webidl_out);
+
+/**
+ * store a parsed Web IDL AST in the cache
+ *
+ * The AST must be stored before any implements are intercalated. The
+ * files included by the IDL files merged into the AST are stored with
+ * it.
+ *
+ * \param key The cache key of the IDL files.
+ * \param webidl The AST root list.
+ * \return 0 on success else -1
+ */
+int webidl_cache_store(uint64_t key, struct webidl_node *webidl);
+
+#endif
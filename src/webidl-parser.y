@@ -20,26 +20,35 @@
 #include <stdint.h>
 #include <math.h>
 
-#define YYFPRINTF webidl_fprintf
+/* the trace is written to the log of the file being parsed which is
+ * reached through the parse-param
+ */
+#define YYFPRINTF(File, ...) webidl_fprintf(parse, File, __VA_ARGS__)
 #define YY_LOCATION_PRINT(File, Loc)                            \
-  webidl_fprintf(File, "%d.%d-%d.%d",                           \
+  webidl_fprintf(parse, File, "%d.%d-%d.%d",                    \
                  (Loc).first_line, (Loc).first_column,          \
                  (Loc).last_line,  (Loc).last_column)
 
 #include "utils.h"
+#include "webidl-ast.h"
 #include "webidl-parser.h"
 #include "webidl-lexer.h"
 
-#include "webidl-ast.h"
+/* bison does not pass the parse-param to yy_stack_print so it finds
+ * this instead and the state stack is left out of the trace
+ */
+static struct webidl_parse *const parse = NULL;
 
-static char *errtxt;
 
 static void
-webidl_error(YYLTYPE *locp, struct webidl_node **winbind_ast, const char *str)
+webidl_error(YYLTYPE *locp,
+             void *scanner,
+             struct webidl_parse *parse,
+             const char *str)
 {
-    UNUSED(locp);
-    UNUSED(winbind_ast);
-    errtxt = strdup(str);
+    UNUSED(scanner);
+    UNUSED(parse);
+    fprintf(stderr, "%d: %s\n", locp->first_line, str);
 }
 
 %}
@@ -50,7 +59,9 @@ webidl_error(YYLTYPE *locp, struct webidl_node **winbind_ast, const char *str)
   */
 %pure-parser
 %error-verbose
-%parse-param { struct webidl_node **webidl_ast }
+%parse-param { void *scanner }
+%parse-param { struct webidl_parse *parse }
+%lex-param { void *scanner }
 
 %union
 {
@@ -234,13 +245,11 @@ Definitions:
         Definitions ExtendedAttributeList Definition
         {
             webidl_node_add($3, $2);
-            $$ = *webidl_ast = webidl_node_prepend(*webidl_ast, $3);
+            $$ = webidl_parse_add_definition(parse, $3);
         }
         |
         error
         {
-            fprintf(stderr, "%d: %s\n", yylloc.first_line, errtxt);
-            free(errtxt);
             YYABORT ;
         }
         ;
@@ -289,25 +298,32 @@ Interface:
                 struct webidl_node *members = NULL;
 
                 if ($3 != NULL) {
-                        members = webidl_node_new(WEBIDL_NODE_TYPE_INHERITANCE,
+                        members = webidl_node_new(parse,
+                                                  WEBIDL_NODE_TYPE_INHERITANCE,
                                                   members,
                                                   $3);
                 }
 
-                members = webidl_node_new(WEBIDL_NODE_TYPE_LIST, members, $5);
+                members = webidl_node_new(parse,
+                                          WEBIDL_NODE_TYPE_LIST,
+                                          members,
+                                          $5);
 
 
-                interface_node = webidl_node_find_type_ident(*webidl_ast,
-                                                     WEBIDL_NODE_TYPE_INTERFACE,
-                                                             $2);
+                interface_node = webidl_parse_find_definition(
+                                                 parse,
+                                                 WEBIDL_NODE_TYPE_INTERFACE,
+                                                 $2);
 
                 if (interface_node == NULL) {
                         /* no existing interface - create one with ident */
-                        members = webidl_node_new(WEBIDL_NODE_TYPE_IDENT,
+                        members = webidl_node_new(parse,
+                                                  WEBIDL_NODE_TYPE_IDENT,
                                                   members,
                                                   $2);
 
-                        $$ = webidl_node_new(WEBIDL_NODE_TYPE_INTERFACE,
+                        $$ = webidl_node_new(parse,
+                                             WEBIDL_NODE_TYPE_INTERFACE,
                                              NULL,
                                              members);
                 } else {
@@ -344,18 +360,25 @@ PartialInterface:
             struct webidl_node *members;
             struct webidl_node *interface_node;
 
-            interface_node = webidl_node_find_type_ident(*webidl_ast,
-                                                     WEBIDL_NODE_TYPE_INTERFACE,
-                                                     $2);
+            interface_node = webidl_parse_find_definition(
+                                                 parse,
+                                                 WEBIDL_NODE_TYPE_INTERFACE,
+                                                 $2);
 
-            members = webidl_node_new(WEBIDL_NODE_TYPE_LIST, NULL, $4);
+            members = webidl_node_new(parse, WEBIDL_NODE_TYPE_LIST, NULL, $4);
 
             if (interface_node == NULL) {
                 /* doesnt already exist so create it */
 
-                members = webidl_node_new(WEBIDL_NODE_TYPE_IDENT, members, $2);
+                members = webidl_node_new(parse,
+                                          WEBIDL_NODE_TYPE_IDENT,
+                                          members,
+                                          $2);
 
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_INTERFACE, NULL, members);
+                $$ = webidl_node_new(parse,
+                                     WEBIDL_NODE_TYPE_INTERFACE,
+                                     NULL,
+                                     members);
             } else {
                 /* update the existing interface */
 
@@ -455,25 +478,31 @@ Dictionary:
                 struct webidl_node *members = NULL;
 
                 if ($3 != NULL) {
-                        members = webidl_node_new(WEBIDL_NODE_TYPE_INHERITANCE,
+                        members = webidl_node_new(parse,
+                                                  WEBIDL_NODE_TYPE_INHERITANCE,
                                                   members,
                                                   $3);
                 }
 
-                members = webidl_node_new(WEBIDL_NODE_TYPE_LIST, members, $5);
+                members = webidl_node_new(parse,
+                                          WEBIDL_NODE_TYPE_LIST,
+                                          members,
+                                          $5);
 
-                dictionary_node = webidl_node_find_type_ident(
-                                         *webidl_ast,
+                dictionary_node = webidl_parse_find_definition(
+                                         parse,
                                          WEBIDL_NODE_TYPE_DICTIONARY,
                                          $2);
 
                 if (dictionary_node == NULL) {
                         /* no existing interface - create one with ident */
-                        members = webidl_node_new(WEBIDL_NODE_TYPE_IDENT,
+                        members = webidl_node_new(parse,
+                                                  WEBIDL_NODE_TYPE_IDENT,
                                                   members,
                                                   $2);
 
-                        $$ = webidl_node_new(WEBIDL_NODE_TYPE_DICTIONARY,
+                        $$ = webidl_node_new(parse,
+                                             WEBIDL_NODE_TYPE_DICTIONARY,
                                              NULL,
                                              members);
                 } else {
@@ -510,24 +539,33 @@ DictionaryMember:
         {
             struct webidl_node *member;
             /* add name */
-            member = webidl_node_new(WEBIDL_NODE_TYPE_IDENT, NULL, $3);
+            member = webidl_node_new(parse, WEBIDL_NODE_TYPE_IDENT, NULL, $3);
             /* add type node */
             member = webidl_node_prepend(member, $2);
 
-            $$ = webidl_node_new(WEBIDL_NODE_TYPE_ARGUMENT, NULL, member);
+            $$ = webidl_node_new(parse,
+                                 WEBIDL_NODE_TYPE_ARGUMENT,
+                                 NULL,
+                                 member);
         }
         |
         Type TOK_IDENTIFIER Default ';'
         {
             struct webidl_node *member;
             /* add name */
-            member = webidl_node_new(WEBIDL_NODE_TYPE_IDENT, NULL, $2);
+            member = webidl_node_new(parse, WEBIDL_NODE_TYPE_IDENT, NULL, $2);
             /* add default */
-            member = webidl_node_new(WEBIDL_NODE_TYPE_OPTIONAL, member, $3);
+            member = webidl_node_new(parse,
+                                     WEBIDL_NODE_TYPE_OPTIONAL,
+                                     member,
+                                     $3);
             /* add type node */
             member = webidl_node_prepend(member, $1);
 
-            $$ = webidl_node_new(WEBIDL_NODE_TYPE_ARGUMENT, NULL, member);
+            $$ = webidl_node_new(parse,
+                                 WEBIDL_NODE_TYPE_ARGUMENT,
+                                 NULL,
+                                 member);
         }
         ;
 
@@ -551,21 +589,26 @@ PartialDictionary:
                 struct webidl_node *members;
                 struct webidl_node *dictionary_node;
 
-                dictionary_node = webidl_node_find_type_ident(
-                                         *webidl_ast,
+                dictionary_node = webidl_parse_find_definition(
+                                         parse,
                                          WEBIDL_NODE_TYPE_DICTIONARY,
                                          $2);
 
-                members = webidl_node_new(WEBIDL_NODE_TYPE_LIST, NULL, $4);
+                members = webidl_node_new(parse,
+                                          WEBIDL_NODE_TYPE_LIST,
+                                          NULL,
+                                          $4);
 
                 if (dictionary_node == NULL) {
                         /* doesnt already exist so create it */
 
-                        members = webidl_node_new(WEBIDL_NODE_TYPE_IDENT,
+                        members = webidl_node_new(parse,
+                                                  WEBIDL_NODE_TYPE_IDENT,
                                                   members,
                                                   $2);
 
-                        $$ = webidl_node_new(WEBIDL_NODE_TYPE_DICTIONARY,
+                        $$ = webidl_node_new(parse,
+                                             WEBIDL_NODE_TYPE_DICTIONARY,
                                              NULL,
                                              members);
                 } else {
@@ -599,7 +642,10 @@ DefaultValue:
         |
         TOK_STRING_LITERAL
         {
-            $$ = webidl_node_new(WEBIDL_NODE_TYPE_LITERAL_STRING, NULL, $1);
+            $$ = webidl_node_new(parse,
+                                 WEBIDL_NODE_TYPE_LITERAL_STRING,
+                                 NULL,
+                                 $1);
         }
         ;
 
@@ -686,18 +732,28 @@ ImplementsStatement:
             struct webidl_node *interface_node;
 
 
-            interface_node = webidl_node_find_type_ident(*webidl_ast,
-                                                     WEBIDL_NODE_TYPE_INTERFACE,
-                                                     $1);
+            interface_node = webidl_parse_find_definition(
+                                                 parse,
+                                                 WEBIDL_NODE_TYPE_INTERFACE,
+                                                 $1);
 
-            implements = webidl_node_new(WEBIDL_NODE_TYPE_INTERFACE_IMPLEMENTS, NULL, $3);
+            implements = webidl_node_new(parse,
+                                         WEBIDL_NODE_TYPE_INTERFACE_IMPLEMENTS,
+                                         NULL,
+                                         $3);
 
             if (interface_node == NULL) {
                 /* interface doesnt already exist so create it */
 
-                implements = webidl_node_new(WEBIDL_NODE_TYPE_IDENT, implements, $1);
+                implements = webidl_node_new(parse,
+                                             WEBIDL_NODE_TYPE_IDENT,
+                                             implements,
+                                             $1);
 
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_INTERFACE, NULL, implements);
+                $$ = webidl_node_new(parse,
+                                     WEBIDL_NODE_TYPE_INTERFACE,
+                                     NULL,
+                                     implements);
             } else {
                 /* update the existing interface */
 
@@ -715,7 +771,7 @@ Const:
         {
             struct webidl_node *constant;
 
-            constant = webidl_node_new(WEBIDL_NODE_TYPE_IDENT, NULL, $3);
+            constant = webidl_node_new(parse, WEBIDL_NODE_TYPE_IDENT, NULL, $3);
 
             /* add constant type */
             constant = webidl_node_prepend(constant, $2);
@@ -723,7 +779,7 @@ Const:
             /* add constant value */
             constant = webidl_node_prepend(constant, $5);
 
-            $$ = webidl_node_new(WEBIDL_NODE_TYPE_CONST, NULL, constant);
+            $$ = webidl_node_new(parse, WEBIDL_NODE_TYPE_CONST, NULL, constant);
         }
         ;
 
@@ -735,14 +791,18 @@ ConstValue:
         |
         TOK_INT_LITERAL
         {
-                $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_LITERAL_INT,
+                $$ = webidl_new_number_node(parse,
+                                            WEBIDL_NODE_TYPE_LITERAL_INT,
                                             NULL,
                                             $1);
         }
         |
         TOK_NULL_LITERAL
         {
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_LITERAL_NULL, NULL, NULL);
+                $$ = webidl_node_new(parse,
+                                     WEBIDL_NODE_TYPE_LITERAL_NULL,
+                                     NULL,
+                                     NULL);
         }
         ;
 
@@ -750,14 +810,16 @@ ConstValue:
 BooleanLiteral:
         TOK_TRUE
         {
-                $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_LITERAL_BOOL,
+                $$ = webidl_new_number_node(parse,
+                                            WEBIDL_NODE_TYPE_LITERAL_BOOL,
                                             NULL,
                                             (int)true);
         }
         |
         TOK_FALSE
         {
-                $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_LITERAL_BOOL,
+                $$ = webidl_new_number_node(parse,
+                                            WEBIDL_NODE_TYPE_LITERAL_BOOL,
                                             NULL,
                                             (int)false);
         }
@@ -767,42 +829,34 @@ BooleanLiteral:
 FloatLiteral:
         TOK_FLOAT_LITERAL
         {
-                float *value;
-                value = malloc(sizeof(float));
-                *value = strtof($1, NULL);
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_LITERAL_FLOAT,
-                                     NULL,
-                                     value);
+                $$ = webidl_new_float_node(parse,
+                                           WEBIDL_NODE_TYPE_LITERAL_FLOAT,
+                                           NULL,
+                                           strtof($1, NULL));
         }
         |
         '-' TOK_INFINITY
         {
-                float *value;
-                value = malloc(sizeof(float));
-                *value = -INFINITY;
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_LITERAL_FLOAT,
-                                     NULL,
-                                     value);
+                $$ = webidl_new_float_node(parse,
+                                           WEBIDL_NODE_TYPE_LITERAL_FLOAT,
+                                           NULL,
+                                           -INFINITY);
         }
         |
         TOK_INFINITY
         {
-                float *value;
-                value = malloc(sizeof(float));
-                *value = INFINITY;
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_LITERAL_FLOAT,
-                                     NULL,
-                                     value);
+                $$ = webidl_new_float_node(parse,
+                                           WEBIDL_NODE_TYPE_LITERAL_FLOAT,
+                                           NULL,
+                                           INFINITY);
         }
         |
         TOK_NAN
         {
-                float *value;
-                value = malloc(sizeof(float));
-                *value = NAN;
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_LITERAL_FLOAT,
-                                     NULL,
-                                     value);
+                $$ = webidl_new_float_node(parse,
+                                           WEBIDL_NODE_TYPE_LITERAL_FLOAT,
+                                           NULL,
+                                           NAN);
         }
         ;
 
@@ -825,7 +879,10 @@ StringifierAttributeOrOperation:
         OperationRest
         {
                 /* @todo deal with stringifier */
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_OPERATION, NULL, $1);
+                $$ = webidl_node_new(parse,
+                                     WEBIDL_NODE_TYPE_OPERATION,
+                                     NULL,
+                                     $1);
         }
         |
         ';'
@@ -847,6 +904,7 @@ Attribute:
                 /* deal with inherit modifier */
                 if ($1) {
                         attribute = webidl_new_number_node(
+                                          parse,
                                           WEBIDL_NODE_TYPE_MODIFIER,
                                           attribute,
                                           WEBIDL_TYPE_MODIFIER_INHERIT);
@@ -855,12 +913,14 @@ Attribute:
                 /* deal with readonly modifier */
                 if ($2) {
                         attribute = webidl_new_number_node(
+                                         parse,
                                          WEBIDL_NODE_TYPE_MODIFIER,
                                          attribute,
                                          WEBIDL_TYPE_MODIFIER_READONLY);
                 }
 
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_ATTRIBUTE,
+                $$ = webidl_node_new(parse,
+                                     WEBIDL_NODE_TYPE_ATTRIBUTE,
                                      NULL,
                                      attribute);
         }
@@ -882,19 +942,22 @@ StaticMemberRest:
         {
                 struct webidl_node *attribute;
 
-                attribute = webidl_new_number_node(WEBIDL_NODE_TYPE_MODIFIER,
+                attribute = webidl_new_number_node(parse,
+                                                   WEBIDL_NODE_TYPE_MODIFIER,
                                                    $2,
                                                    WEBIDL_TYPE_MODIFIER_STATIC);
 
                 /* deal with readonly modifier */
                 if ($1) {
                         attribute = webidl_new_number_node(
+                                         parse,
                                          WEBIDL_NODE_TYPE_MODIFIER,
                                          attribute,
                                          WEBIDL_TYPE_MODIFIER_READONLY);
                 }
 
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_ATTRIBUTE,
+                $$ = webidl_node_new(parse,
+                                     WEBIDL_NODE_TYPE_ATTRIBUTE,
                                      NULL,
                                      attribute);
         }
@@ -904,14 +967,16 @@ StaticMemberRest:
                 struct webidl_node *operation;
 
                 /* add static modifier */
-                operation = webidl_new_number_node(WEBIDL_NODE_TYPE_MODIFIER,
+                operation = webidl_new_number_node(parse,
+                                                   WEBIDL_NODE_TYPE_MODIFIER,
                                                    $2,
                                                    WEBIDL_TYPE_MODIFIER_STATIC);
 
                 /* put return type on the operation */
                 operation = webidl_node_prepend($1, operation);
 
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_OPERATION,
+                $$ = webidl_node_new(parse,
+                                     WEBIDL_NODE_TYPE_OPERATION,
                                      NULL,
                                      operation);
         }
@@ -922,7 +987,7 @@ StaticMemberRest:
 AttributeRest:
         TOK_ATTRIBUTE Type AttributeName ';'
         {
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_IDENT, $2, $3);
+                $$ = webidl_node_new(parse, WEBIDL_NODE_TYPE_IDENT, $2, $3);
         }
         ;
 
@@ -937,7 +1002,7 @@ AttributeName:
 AttributeNameKeyword:
         TOK_REQUIRED
         {
-                $$ = strdup("required");
+                $$ = webidl_strdup(parse, "required");
         }
 
 /* [33]
@@ -979,12 +1044,18 @@ Operation:
                 /* put return type on the operation */
                 $2 = webidl_node_prepend($1, $2);
 
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_OPERATION, NULL, $2);
+                $$ = webidl_node_new(parse,
+                                     WEBIDL_NODE_TYPE_OPERATION,
+                                     NULL,
+                                     $2);
         }
         |
         SpecialOperation
         {
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_OPERATION, NULL, $1);
+                $$ = webidl_node_new(parse,
+                                     WEBIDL_NODE_TYPE_OPERATION,
+                                     NULL,
+                                     $1);
         }
         ;
 
@@ -1020,14 +1091,16 @@ Specials:
 Special:
         TOK_GETTER
         {
-                $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_SPECIAL,
+                $$ = webidl_new_number_node(parse,
+                                            WEBIDL_NODE_TYPE_SPECIAL,
                                             NULL,
                                             WEBIDL_TYPE_SPECIAL_GETTER);
         }
         |
         TOK_SETTER
         {
-                $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_SPECIAL,
+                $$ = webidl_new_number_node(parse,
+                                            WEBIDL_NODE_TYPE_SPECIAL,
                                             NULL,
                                             WEBIDL_TYPE_SPECIAL_SETTER);
         }
@@ -1037,21 +1110,24 @@ Special:
                 /* second edition removed this special but the
                  * specifications still use it!
                  */
-                $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_SPECIAL,
+                $$ = webidl_new_number_node(parse,
+                                            WEBIDL_NODE_TYPE_SPECIAL,
                                             NULL,
                                             WEBIDL_TYPE_SPECIAL_CREATOR);
         }
         |
         TOK_DELETER
         {
-                $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_SPECIAL,
+                $$ = webidl_new_number_node(parse,
+                                            WEBIDL_NODE_TYPE_SPECIAL,
                                             NULL,
                                             WEBIDL_TYPE_SPECIAL_DELETER);
         }
         |
         TOK_LEGACYCALLER
         {
-                $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_SPECIAL,
+                $$ = webidl_new_number_node(parse,
+                                            WEBIDL_NODE_TYPE_SPECIAL,
                                             NULL,
                                             WEBIDL_TYPE_SPECIAL_LEGACYCALLER);
         }
@@ -1062,7 +1138,7 @@ OperationRest:
         OptionalIdentifier '(' ArgumentList ')' ';'
         {
                 /* argument list */
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_LIST, NULL, $3);
+                $$ = webidl_node_new(parse, WEBIDL_NODE_TYPE_LIST, NULL, $3);
 
                 $$ = webidl_node_prepend($1, $$); /* identifier */
         }
@@ -1077,7 +1153,7 @@ OptionalIdentifier:
         |
         TOK_IDENTIFIER
         {
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_IDENT, NULL, $1);
+                $$ = webidl_node_new(parse, WEBIDL_NODE_TYPE_IDENT, NULL, $1);
         }
         ;
 
@@ -1124,19 +1200,28 @@ OptionalOrRequiredArgument:
         TOK_OPTIONAL Type ArgumentName Default
         {
             struct webidl_node *argument;
-            argument = webidl_node_new(WEBIDL_NODE_TYPE_IDENT, NULL, $3);
-            argument = webidl_node_new(WEBIDL_NODE_TYPE_OPTIONAL, argument, $4);
+            argument = webidl_node_new(parse, WEBIDL_NODE_TYPE_IDENT, NULL, $3);
+            argument = webidl_node_new(parse,
+                                       WEBIDL_NODE_TYPE_OPTIONAL,
+                                       argument,
+                                       $4);
             argument = webidl_node_prepend(argument, $2); /* add type node */
-            $$ = webidl_node_new(WEBIDL_NODE_TYPE_ARGUMENT, NULL, argument);
+            $$ = webidl_node_new(parse,
+                                 WEBIDL_NODE_TYPE_ARGUMENT,
+                                 NULL,
+                                 argument);
         }
         |
         Type Ellipsis ArgumentName
         {
             struct webidl_node *argument;
-            argument = webidl_node_new(WEBIDL_NODE_TYPE_IDENT, NULL, $3);
+            argument = webidl_node_new(parse, WEBIDL_NODE_TYPE_IDENT, NULL, $3);
             argument = webidl_node_prepend(argument, $2); /* ellipsis node */
             argument = webidl_node_prepend(argument, $1); /* add type node */
-            $$ = webidl_node_new(WEBIDL_NODE_TYPE_ARGUMENT, NULL, argument);
+            $$ = webidl_node_new(parse,
+                                 WEBIDL_NODE_TYPE_ARGUMENT,
+                                 NULL,
+                                 argument);
         }
         ;
 
@@ -1156,7 +1241,10 @@ Ellipsis:
         |
         TOK_ELLIPSIS
         {
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_ELLIPSIS, NULL, NULL);
+                $$ = webidl_node_new(parse,
+                                     WEBIDL_NODE_TYPE_ELLIPSIS,
+                                     NULL,
+                                     NULL);
         }
         ;
 
@@ -1207,7 +1295,8 @@ ExtendedAttributeList:
         |
         '[' ExtendedAttribute ExtendedAttributes ']'
         {
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE,
+                $$ = webidl_node_new(parse,
+                                     WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE,
                                      $3,
                                      $2);
         }
@@ -1222,7 +1311,8 @@ ExtendedAttributes:
         |
         ',' ExtendedAttribute ExtendedAttributes
         {
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE,
+                $$ = webidl_node_new(parse,
+                                     WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE,
                                      $3,
                                      $2);
         }
@@ -1234,37 +1324,50 @@ ExtendedAttributes:
 ExtendedAttribute:
         '(' ExtendedAttributeInner ')' ExtendedAttributeRest
         {
-            $$ = webidl_node_new(WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE, $4, $2);
+            $$ = webidl_node_new(parse,
+                                 WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE,
+                                 $4,
+                                 $2);
         }
         |
         '[' ExtendedAttributeInner ']' ExtendedAttributeRest
         {
             /* @todo should be a WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE_SQUARE */
-            $$ = webidl_node_new(WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE, $4, $2);
+            $$ = webidl_node_new(parse,
+                                 WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE,
+                                 $4,
+                                 $2);
         }
         |
         '{' ExtendedAttributeInner '}' ExtendedAttributeRest
         {
             /* @todo should be a WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE_CURLY */
-            $$ = webidl_node_new(WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE, $4, $2);
+            $$ = webidl_node_new(parse,
+                                 WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE,
+                                 $4,
+                                 $2);
         }
         |
         TOK_CONSTRUCTOR
         {
                 /* Constructor */
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_IDENT,
+                $$ = webidl_node_new(parse,
+                                     WEBIDL_NODE_TYPE_IDENT,
                                      NULL,
-                                     strdup("Constructor"));
+                                     webidl_strdup(parse, "Constructor"));
         }
         |
         TOK_CONSTRUCTOR '(' ArgumentList ')'
         {
                 /* Constructor */
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_OPERATION,
-                                     webidl_node_new(WEBIDL_NODE_TYPE_IDENT,
+                $$ = webidl_node_new(parse,
+                                     WEBIDL_NODE_TYPE_OPERATION,
+                                     webidl_node_new(parse,
+                                                     WEBIDL_NODE_TYPE_IDENT,
                                                      NULL,
-                                                     strdup("Constructor")),
-                                     webidl_node_new(WEBIDL_NODE_TYPE_LIST,
+                                                     webidl_strdup(parse, "Constructor")),
+                                     webidl_node_new(parse,
+                                                     WEBIDL_NODE_TYPE_LIST,
                                                      NULL,
                                                      $3));
         }
@@ -1272,12 +1375,16 @@ ExtendedAttribute:
         TOK_NAMEDCONSTRUCTOR '=' TOK_IDENTIFIER '(' ArgumentList ')'
         {
                 /* Constructor */
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_OPERATION,
-                                     webidl_node_new(WEBIDL_NODE_TYPE_IDENT,
+                $$ = webidl_node_new(parse,
+                                     WEBIDL_NODE_TYPE_OPERATION,
+                                     webidl_node_new(parse,
+                                                     WEBIDL_NODE_TYPE_IDENT,
                                                      NULL,
-                                                     strdup("NamedConstructor")),
-                                     webidl_node_new(WEBIDL_NODE_TYPE_LIST,
-                                                     webidl_node_new(WEBIDL_NODE_TYPE_IDENT,
+                                                     webidl_strdup(parse, "NamedConstructor")),
+                                     webidl_node_new(parse,
+                                                     WEBIDL_NODE_TYPE_LIST,
+                                                     webidl_node_new(parse,
+                                                                     WEBIDL_NODE_TYPE_IDENT,
                                                                      NULL,
                                                                      $3),
                                                      $5));
@@ -1286,7 +1393,8 @@ ExtendedAttribute:
         Other ExtendedAttributeRest
         {
                 $$ = webidl_node_append($2,
-                                        webidl_node_new(WEBIDL_NODE_TYPE_IDENT,
+                                        webidl_node_new(parse,
+                                                        WEBIDL_NODE_TYPE_IDENT,
                                                         NULL,
                                                         $1));
         }
@@ -1315,7 +1423,8 @@ ExtendedAttributeInner:
         '(' ExtendedAttributeInner ')' ExtendedAttributeInner
         {
                 $$ = webidl_node_prepend(
-                        webidl_node_new(WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE,
+                        webidl_node_new(parse,
+                                        WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE,
                                         NULL,
                                         $2),
                         $4);
@@ -1325,7 +1434,8 @@ ExtendedAttributeInner:
         {
             /* @todo should be a WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE_SQUARE */
             $$ = webidl_node_prepend(
-                     webidl_node_new(WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE,
+                     webidl_node_new(parse,
+                                     WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE,
                                      NULL,
                                      $2),
                      $4);
@@ -1335,7 +1445,8 @@ ExtendedAttributeInner:
         {
             /* @todo should be a WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE_CURLY */
             $$ = webidl_node_prepend(
-                     webidl_node_new(WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE,
+                     webidl_node_new(parse,
+                                     WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE,
                                      NULL,
                                      $2),
                      $4);
@@ -1344,7 +1455,8 @@ ExtendedAttributeInner:
         OtherOrComma ExtendedAttributeInner
         {
                 $$ = webidl_node_append($2,
-                                        webidl_node_new(WEBIDL_NODE_TYPE_IDENT,
+                                        webidl_node_new(parse,
+                                                        WEBIDL_NODE_TYPE_IDENT,
                                                         NULL,
                                                         $1));
         }
@@ -1355,8 +1467,9 @@ Other:
         TOK_INT_LITERAL
         {
                 /* @todo loosing base info here might break the attribute */
-                $$ = calloc(1, 32);
-                snprintf($$, 32, "%ld", $1);
+                char number[32];
+                snprintf(number, sizeof(number), "%ld", $1);
+                $$ = webidl_strdup(parse, number);
         }
         |
         TOK_FLOAT_LITERAL
@@ -1381,152 +1494,152 @@ Other:
         |
         '-'
         {
-                $$ = strdup("-");
+                $$ = webidl_strdup(parse, "-");
         }
         |
         '.'
         {
-                $$ = strdup(".");
+                $$ = webidl_strdup(parse, ".");
         }
         |
         TOK_ELLIPSIS
         {
-                $$ = strdup("...");
+                $$ = webidl_strdup(parse, "...");
         }
         |
         ':'
         {
-                $$ = strdup(":");
+                $$ = webidl_strdup(parse, ":");
         }
         |
         ';'
         {
-                $$ = strdup(";");
+                $$ = webidl_strdup(parse, ";");
         }
         |
         '<'
         {
-                $$ = strdup("<");
+                $$ = webidl_strdup(parse, "<");
         }
         |
         '='
         {
-                $$ = strdup("=");
+                $$ = webidl_strdup(parse, "=");
         }
         |
         '>'
         {
-                $$ = strdup(">");
+                $$ = webidl_strdup(parse, ">");
         }
         |
         '?'
         {
-                $$ = strdup("?");
+                $$ = webidl_strdup(parse, "?");
         }
         |
         TOK_DATE
         {
-                $$ = strdup("Date");
+                $$ = webidl_strdup(parse, "Date");
         }
         |
         TOK_STRING
         {
-                $$ = strdup("DOMString");
+                $$ = webidl_strdup(parse, "DOMString");
         }
         |
         TOK_INFINITY
         {
-                $$ = strdup("Infinity");
+                $$ = webidl_strdup(parse, "Infinity");
         }
         |
         TOK_NAN
         {
-                $$ = strdup("NaN");
+                $$ = webidl_strdup(parse, "NaN");
         }
         |
         TOK_ANY
         {
-                $$ = strdup("any");
+                $$ = webidl_strdup(parse, "any");
         }
         |
         TOK_BOOLEAN
         {
-                $$ = strdup("boolean");
+                $$ = webidl_strdup(parse, "boolean");
         }
         |
         TOK_BYTE
         {
-                $$ = strdup("byte");
+                $$ = webidl_strdup(parse, "byte");
         }
         |
         TOK_DOUBLE
         {
-                $$ = strdup("double");
+                $$ = webidl_strdup(parse, "double");
         }
         |
         TOK_FALSE
         {
-                $$ = strdup("false");
+                $$ = webidl_strdup(parse, "false");
         }
         |
         TOK_FLOAT
         {
-            $$ = strdup("float");
+            $$ = webidl_strdup(parse, "float");
         }
         |
         TOK_LONG
         {
-            $$ = strdup("long");
+            $$ = webidl_strdup(parse, "long");
         }
         |
         TOK_NULL_LITERAL
         {
-            $$ = strdup("null");
+            $$ = webidl_strdup(parse, "null");
         }
         |
         TOK_OBJECT
         {
-            $$ = strdup("object");
+            $$ = webidl_strdup(parse, "object");
         }
         |
         TOK_OCTET
         {
-            $$ = strdup("octet");
+            $$ = webidl_strdup(parse, "octet");
         }
         |
         TOK_OR
         {
-            $$ = strdup("or");
+            $$ = webidl_strdup(parse, "or");
         }
         |
         TOK_OPTIONAL
         {
-            $$ = strdup("optional");
+            $$ = webidl_strdup(parse, "optional");
         }
         |
         TOK_SEQUENCE
         {
-            $$ = strdup("sequence");
+            $$ = webidl_strdup(parse, "sequence");
         }
         |
         TOK_SHORT
         {
-            $$ = strdup("short");
+            $$ = webidl_strdup(parse, "short");
         }
         |
         TOK_TRUE
         {
-            $$ = strdup("true");
+            $$ = webidl_strdup(parse, "true");
         }
         |
         TOK_UNSIGNED
         {
-            $$ = strdup("unsigned");
+            $$ = webidl_strdup(parse, "unsigned");
         }
         |
         TOK_VOID
         {
-            $$ = strdup("void");
+            $$ = webidl_strdup(parse, "void");
         }
         |
         ArgumentNameKeyword
@@ -1541,112 +1654,112 @@ Other:
 ArgumentNameKeyword:
         TOK_ATTRIBUTE
         {
-            $$ = strdup("attribute");
+            $$ = webidl_strdup(parse, "attribute");
         }
         |
         TOK_CALLBACK
         {
-            $$ = strdup("callback");
+            $$ = webidl_strdup(parse, "callback");
         }
         |
         TOK_CONST
         {
-            $$ = strdup("const");
+            $$ = webidl_strdup(parse, "const");
         }
         |
         TOK_CREATOR
         {
-            $$ = strdup("creator");
+            $$ = webidl_strdup(parse, "creator");
         }
         |
         TOK_DELETER
         {
-            $$ = strdup("deleter");
+            $$ = webidl_strdup(parse, "deleter");
         }
         |
         TOK_DICTIONARY
         {
-            $$ = strdup("dictionary");
+            $$ = webidl_strdup(parse, "dictionary");
         }
         |
         TOK_ENUM
         {
-            $$ = strdup("enum");
+            $$ = webidl_strdup(parse, "enum");
         }
         |
         TOK_EXCEPTION
         {
-            $$ = strdup("exception");
+            $$ = webidl_strdup(parse, "exception");
         }
         |
         TOK_GETTER
         {
-            $$ = strdup("getter");
+            $$ = webidl_strdup(parse, "getter");
         }
         |
         TOK_IMPLEMENTS
         {
-            $$ = strdup("implements");
+            $$ = webidl_strdup(parse, "implements");
         }
         |
         TOK_INHERIT
         {
-            $$ = strdup("inherit");
+            $$ = webidl_strdup(parse, "inherit");
         }
         |
         TOK_INTERFACE
         {
-            $$ = strdup("interface");
+            $$ = webidl_strdup(parse, "interface");
         }
         |
         TOK_ITERABLE
         {
-            $$ = strdup("iterable");
+            $$ = webidl_strdup(parse, "iterable");
         }
         |
         TOK_LEGACYCALLER
         {
-            $$ = strdup("legacycaller");
+            $$ = webidl_strdup(parse, "legacycaller");
         }
         |
         TOK_LEGACYITERABLE
         {
-            $$ = strdup("legacyiterable");
+            $$ = webidl_strdup(parse, "legacyiterable");
         }
         |
         TOK_PARTIAL
         {
-            $$ = strdup("partial");
+            $$ = webidl_strdup(parse, "partial");
         }
         |
         TOK_REQUIRED
         {
-            $$ = strdup("required");
+            $$ = webidl_strdup(parse, "required");
         }
         |
         TOK_SETTER
         {
-            $$ = strdup("setter");
+            $$ = webidl_strdup(parse, "setter");
         }
         |
         TOK_STATIC
         {
-            $$ = strdup("static");
+            $$ = webidl_strdup(parse, "static");
         }
         |
         TOK_STRINGIFIER
         {
-            $$ = strdup("stringifier");
+            $$ = webidl_strdup(parse, "stringifier");
         }
         |
         TOK_TYPEDEF
         {
-            $$ = strdup("typedef");
+            $$ = webidl_strdup(parse, "typedef");
         }
         |
         TOK_UNRESTRICTED
         {
-            $$ = strdup("unrestricted");
+            $$ = webidl_strdup(parse, "unrestricted");
         }
         ;
 
@@ -1659,7 +1772,7 @@ OtherOrComma:
         |
         ','
         {
-            $$ = strdup(",");
+            $$ = webidl_strdup(parse, ",");
         }
         ;
 
@@ -1667,7 +1780,7 @@ OtherOrComma:
 Type:
         SingleType
         {
-            $$ = webidl_node_new(WEBIDL_NODE_TYPE_TYPE, NULL, $1);
+            $$ = webidl_node_new(parse, WEBIDL_NODE_TYPE_TYPE, NULL, $1);
         }
         |
         UnionType TypeSuffix
@@ -1684,7 +1797,8 @@ SingleType:
         TOK_ANY TypeSuffixStartingWithArray
         {
                 /* todo deal with TypeSuffixStartingWithArray */
-                $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_TYPE_BASE,
+                $$ = webidl_new_number_node(parse,
+                                            WEBIDL_NODE_TYPE_TYPE_BASE,
                                             NULL,
                                             WEBIDL_TYPE_ANY);
         }
@@ -1702,7 +1816,7 @@ UnionType:
 UnionMemberType:
         NonAnyType
         {
-                $$ = webidl_node_new(WEBIDL_NODE_TYPE_TYPE, NULL, $1);
+                $$ = webidl_node_new(parse, WEBIDL_NODE_TYPE_TYPE, NULL, $1);
         }
         |
         UnionType TypeSuffix
@@ -1748,7 +1862,8 @@ NonAnyType:
         |
         TOK_STRING TypeSuffix
         {
-            $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_TYPE_BASE,
+            $$ = webidl_new_number_node(parse,
+                                        WEBIDL_NODE_TYPE_TYPE_BASE,
                                         $2,
                                         WEBIDL_TYPE_STRING);
         }
@@ -1756,29 +1871,33 @@ NonAnyType:
         TOK_IDENTIFIER TypeSuffix
         {
             struct webidl_node *type;
-            type = webidl_new_number_node(WEBIDL_NODE_TYPE_TYPE_BASE,
+            type = webidl_new_number_node(parse,
+                                          WEBIDL_NODE_TYPE_TYPE_BASE,
                                           $2,
                                           WEBIDL_TYPE_USER);
-            $$ = webidl_node_new(WEBIDL_NODE_TYPE_IDENT, type, $1);
+            $$ = webidl_node_new(parse, WEBIDL_NODE_TYPE_IDENT, type, $1);
         }
         |
         TOK_SEQUENCE '<' Type '>' Null
         {
-            $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_TYPE_BASE,
+            $$ = webidl_new_number_node(parse,
+                                        WEBIDL_NODE_TYPE_TYPE_BASE,
                                         $3,
                                         WEBIDL_TYPE_SEQUENCE);
         }
         |
         TOK_OBJECT TypeSuffix
         {
-            $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_TYPE_BASE,
+            $$ = webidl_new_number_node(parse,
+                                        WEBIDL_NODE_TYPE_TYPE_BASE,
                                         $2,
                                         WEBIDL_TYPE_OBJECT);
         }
         |
         TOK_DATE TypeSuffix
         {
-            $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_TYPE_BASE,
+            $$ = webidl_new_number_node(parse,
+                                        WEBIDL_NODE_TYPE_TYPE_BASE,
                                         $2,
                                         WEBIDL_TYPE_DATE);
         }
@@ -1788,17 +1907,18 @@ NonAnyType:
 ConstType:
         PrimitiveType Null
         {
-            $$ = webidl_node_new(WEBIDL_NODE_TYPE_TYPE, NULL, $1);
+            $$ = webidl_node_new(parse, WEBIDL_NODE_TYPE_TYPE, NULL, $1);
         }
         |
         TOK_IDENTIFIER Null
         {
             struct webidl_node *type;
-            type = webidl_new_number_node(WEBIDL_NODE_TYPE_TYPE_BASE,
+            type = webidl_new_number_node(parse,
+                                          WEBIDL_NODE_TYPE_TYPE_BASE,
                                           NULL,
                                           WEBIDL_TYPE_USER);
-            type = webidl_node_new(WEBIDL_NODE_TYPE_IDENT, type, $1);
-            $$ = webidl_node_new(WEBIDL_NODE_TYPE_TYPE, NULL, type);
+            type = webidl_node_new(parse, WEBIDL_NODE_TYPE_IDENT, type, $1);
+            $$ = webidl_node_new(parse, WEBIDL_NODE_TYPE_TYPE, NULL, type);
         }
 
         ;
@@ -1811,21 +1931,24 @@ PrimitiveType:
         |
         TOK_BOOLEAN
         {
-            $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_TYPE_BASE,
+            $$ = webidl_new_number_node(parse,
+                                        WEBIDL_NODE_TYPE_TYPE_BASE,
                                         NULL,
                                         WEBIDL_TYPE_BOOL);
         }
         |
         TOK_BYTE
         {
-            $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_TYPE_BASE,
+            $$ = webidl_new_number_node(parse,
+                                        WEBIDL_NODE_TYPE_TYPE_BASE,
                                         NULL,
                                         WEBIDL_TYPE_BYTE);
         }
         |
         TOK_OCTET
         {
-            $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_TYPE_BASE,
+            $$ = webidl_new_number_node(parse,
+                                        WEBIDL_NODE_TYPE_TYPE_BASE,
                                         NULL,
                                         WEBIDL_TYPE_OCTET);
         }
@@ -1835,7 +1958,8 @@ PrimitiveType:
 UnrestrictedFloatType:
         TOK_UNRESTRICTED FloatType
         {
-            $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_MODIFIER,
+            $$ = webidl_new_number_node(parse,
+                                        WEBIDL_NODE_TYPE_MODIFIER,
                                         $2,
                                         WEBIDL_TYPE_MODIFIER_UNRESTRICTED);
         }
@@ -1847,14 +1971,16 @@ UnrestrictedFloatType:
 FloatType:
         TOK_FLOAT
         {
-            $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_TYPE_BASE,
+            $$ = webidl_new_number_node(parse,
+                                        WEBIDL_NODE_TYPE_TYPE_BASE,
                                         NULL,
                                         WEBIDL_TYPE_FLOAT);
         }
         |
         TOK_DOUBLE
         {
-            $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_TYPE_BASE,
+            $$ = webidl_new_number_node(parse,
+                                        WEBIDL_NODE_TYPE_TYPE_BASE,
                                         NULL,
                                         WEBIDL_TYPE_DOUBLE);
         }
@@ -1864,7 +1990,8 @@ FloatType:
 UnsignedIntegerType:
         TOK_UNSIGNED IntegerType
         {
-            $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_MODIFIER,
+            $$ = webidl_new_number_node(parse,
+                                        WEBIDL_NODE_TYPE_MODIFIER,
                                         $2,
                                         WEBIDL_TYPE_MODIFIER_UNSIGNED);
         }
@@ -1876,7 +2003,8 @@ UnsignedIntegerType:
 IntegerType:
         TOK_SHORT
         {
-            $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_TYPE_BASE,
+            $$ = webidl_new_number_node(parse,
+                                        WEBIDL_NODE_TYPE_TYPE_BASE,
                                         NULL,
                                         WEBIDL_TYPE_SHORT);
         }
@@ -1884,11 +2012,13 @@ IntegerType:
         TOK_LONG OptionalLong
         {
             if ($2) {
-                $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_TYPE_BASE,
+                $$ = webidl_new_number_node(parse,
+                                            WEBIDL_NODE_TYPE_TYPE_BASE,
                                             NULL,
                                             WEBIDL_TYPE_LONGLONG);
             } else {
-                $$ = webidl_new_number_node(WEBIDL_NODE_TYPE_TYPE_BASE,
+                $$ = webidl_new_number_node(parse,
+                                            WEBIDL_NODE_TYPE_TYPE_BASE,
                                             NULL,
                                             WEBIDL_TYPE_LONG);
             }
@@ -1925,12 +2055,15 @@ TypeSuffix:
         |
         '[' ']' TypeSuffix
         {
-            $$ = webidl_node_new(WEBIDL_NODE_TYPE_TYPE_ARRAY, $3, NULL);
+            $$ = webidl_node_new(parse, WEBIDL_NODE_TYPE_TYPE_ARRAY, $3, NULL);
         }
         |
         '?' TypeSuffixStartingWithArray
         {
-            $$ = webidl_node_new(WEBIDL_NODE_TYPE_TYPE_NULLABLE, $2, NULL);
+            $$ = webidl_node_new(parse,
+                                 WEBIDL_NODE_TYPE_TYPE_NULLABLE,
+                                 $2,
+                                 NULL);
         }
         ;
 
@@ -1943,7 +2076,7 @@ TypeSuffixStartingWithArray:
         |
         '[' ']' TypeSuffix
         {
-            $$ = webidl_node_new(WEBIDL_NODE_TYPE_TYPE_ARRAY, $3, NULL);
+            $$ = webidl_node_new(parse, WEBIDL_NODE_TYPE_TYPE_ARRAY, $3, NULL);
         }
         ;
 
@@ -1961,10 +2094,11 @@ ReturnType:
         TOK_VOID
         {
             struct webidl_node *type;
-            type = webidl_new_number_node(WEBIDL_NODE_TYPE_TYPE_BASE,
+            type = webidl_new_number_node(parse,
+                                          WEBIDL_NODE_TYPE_TYPE_BASE,
                                           NULL,
                                           WEBIDL_TYPE_VOID);
-            $$ = webidl_node_new(WEBIDL_NODE_TYPE_TYPE, NULL, type);
+            $$ = webidl_node_new(parse, WEBIDL_NODE_TYPE_TYPE, NULL, type);
         }
 
         ;
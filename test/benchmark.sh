@@ -0,0 +1,256 @@
+#!/bin/sh
+#
+# Synthetic scaling benchmark for nsgenbind
+#
+# Generates deterministic Web IDL and binding sources of increasing
+#  size, times and memory profiles each pipeline phase and reports the
+#  phases whose time grows faster than the input.
+#
+# usage: benchmark.sh builddir [interfaces ...]
+
+BUILDDIR=$1
+shift
+
+# number of interfaces in each generated input
+SIZES=${*:-"50 100 200 400 800"}
+
+# shape of the generated input
+DEPTH=${BENCH_DEPTH:-16} # length of inheritance chains
+PARTIALS=${BENCH_PARTIALS:-3} # partial interfaces per interface
+MIXINS=${BENCH_MIXINS:-2} # implements statements per interface
+OVERLOADS=${BENCH_OVERLOADS:-6} # overloads of each operation
+CDATA=${BENCH_CDATA:-200} # lines in each binding code block
+
+# genbind tool
+NSGENBIND=${BUILDDIR}/nsgenbind
+
+# benchmark output
+BENCHOUTDIR=${BUILDDIR}/benchmark
+# overall results
+LOGFILE=${BENCHOUTDIR}/benchlog
+
+# write the Web IDL for $1 interfaces into directory $2
+#
+# bench.idl holds the interfaces, mixins and dictionaries, partial.idl
+#  the partial interfaces and implements.idl the implements statements
+#  so there are several files to parse.
+gen_idl() {
+    awk -v n=$1 -v depth=${DEPTH} -v partials=${PARTIALS} \
+        -v mixins=${MIXINS} -v overloads=${OVERLOADS} \
+        -v idl=$2/bench.idl -v partial=$2/partial.idl \
+        -v impl=$2/implements.idl '
+    function members(file, name, count,    m, o, a) {
+        for (m = 0; m < count; m++) {
+            printf("  const unsigned short %s_CONST_%d = %d;\n",
+                   toupper(name), m, m) > file
+            printf("  attribute DOMString %sAttr%d;\n", name, m) > file
+            printf("  [TreatNullAs=EmptyString] attribute DOMString? %sNullable%d;\n",
+                   name, m) > file
+            printf("  readonly attribute unsigned long %sCount%d;\n",
+                   name, m) > file
+        }
+        # one operation with many overloads differing by argument count
+        for (o = 0; o < overloads; o++) {
+            printf("  boolean %sOp(", name) > file
+            for (a = 0; a <= o; a++) {
+                if (a > 0) printf(", ") > file
+                if (a == o && o > 1) printf("optional ") > file
+                printf("%s arg%d", (a % 2) ? "long" : "DOMString", a) > file
+            }
+            printf(");\n") > file
+        }
+        printf("  void %sVariadic(DOMString first, any... rest);\n",
+               name) > file
+    }
+    BEGIN {
+        nmixin = int(n / 4) + 1
+        ndict = int(n / 4) + 1
+
+        for (m = 0; m < nmixin; m++) {
+            printf("[NoInterfaceObject]\ninterface Mixin%d {\n", m) > idl
+            members(idl, "mixin" m, 2)
+            printf("};\n\n") > idl
+        }
+
+        for (d = 0; d < ndict; d++) {
+            printf("dictionary Dict%d", d) > idl
+            if ((d % depth) != 0) printf(" : Dict%d", d - 1) > idl
+            printf(" {\n  DOMString key%d = \"value%d\";\n", d, d) > idl
+            printf("  long count%d = %d;\n", d, d) > idl
+            printf("  boolean flag%d = false;\n};\n\n", d) > idl
+        }
+
+        for (i = 0; i < n; i++) {
+            if ((i % depth) == 0) {
+                printf("[Constructor(DOMString name, optional Dict%d init)]\n",
+                       i % ndict) > idl
+                printf("interface Iface%d {\n", i) > idl
+            } else {
+                printf("interface Iface%d : Iface%d {\n", i, i - 1) > idl
+            }
+            members(idl, "iface" i, 4)
+            printf("  Iface%d? next%d(optional Dict%d options);\n",
+                   (i + 1) % n, i, i % ndict) > idl
+            printf("};\n\n") > idl
+
+            for (p = 0; p < partials; p++) {
+                printf("partial interface Iface%d {\n", i) > partial
+                members(partial, "part" p "iface" i, 1)
+                printf("};\n\n") > partial
+            }
+
+            for (m = 0; m < mixins; m++) {
+                printf("Iface%d implements Mixin%d;\n",
+                       i, ((i * 7) + (m * 3)) % nmixin) > impl
+            }
+        }
+    }'
+}
+
+# write a block of $1 lines of C as binding code
+gen_cdata() {
+    awk -v lines=$1 -v name=$2 'BEGIN {
+        printf("%%{\n")
+        for (l = 0; l < lines; l++) {
+            printf("\t/* %s line %d */ if (ctx == NULL) return %d;\n",
+                   name, l, l)
+        }
+        printf("%%}\n")
+    }'
+}
+
+# write the binding for $1 interfaces into directory $2
+gen_bnd() {
+    {
+        cat <<EOF
+/* synthetic binding generated by the nsgenbind benchmark */
+
+binding duk_libdom {
+	webidl "bench.idl";
+	webidl "partial.idl";
+	webidl "implements.idl";
+
+	preface
+EOF
+        gen_cdata ${CDATA} preface
+        echo "	;"
+        echo "	prologue"
+        gen_cdata ${CDATA} prologue
+        echo "	;"
+        echo "};"
+        echo
+
+        i=0
+        while [ ${i} -lt $1 ]; do
+            echo "class Iface${i} {"
+            echo "	private int value${i};"
+            echo "	prologue"
+            gen_cdata ${CDATA} Iface${i}
+            echo "	;"
+            echo "};"
+            echo
+            if [ $((i % DEPTH)) -eq 0 ]; then
+                echo "init Iface${i}(int value${i})"
+            else
+                echo "init Iface${i}(int value$((i - i % DEPTH)))"
+            fi
+            gen_cdata ${CDATA} init${i}
+            echo
+            echo "method Iface${i}::iface${i}Op()"
+            gen_cdata ${CDATA} method${i}
+            echo
+            echo "getter Iface${i}::iface${i}Attr0()"
+            gen_cdata 4 getter${i}
+            echo
+            echo "setter Iface${i}::iface${i}Attr0()"
+            gen_cdata 4 setter${i}
+            echo
+            i=$((i + 1))
+        done
+    } > $2/bench.bnd
+}
+
+# sum the duration in milliseconds of each span in a trace
+#
+# nsgenbind writes each trace event on a line of its own.
+trace_phases() {
+    awk -v size=$2 '
+        /"ph":"X"/ {
+            name = $0
+            sub(/.*"name":"/, "", name)
+            sub(/".*/, "", name)
+            dur = $0
+            sub(/.*"dur":/, "", dur)
+            sub(/[^0-9].*/, "", dur)
+            total[name] += dur
+        }
+        END {
+            for (name in total) {
+                printf("%s %d %.3f\n", name, size, total[name] / 1000)
+            }
+        }' $1
+}
+
+mkdir -p ${BENCHOUTDIR}
+echo "$*" > ${LOGFILE}
+: > ${BENCHOUTDIR}/phases
+
+for SIZE in ${SIZES}; do
+    SIZEDIR=${BENCHOUTDIR}/${SIZE}
+
+    rm -rf ${SIZEDIR}
+    mkdir -p ${SIZEDIR}/out
+
+    # the partial and implements files may be left empty
+    : > ${SIZEDIR}/partial.idl
+    : > ${SIZEDIR}/implements.idl
+    gen_idl ${SIZE} ${SIZEDIR}
+    gen_bnd ${SIZE} ${SIZEDIR}
+
+    echo -n "    BENCH: ${SIZE} interfaces......"
+
+    echo ${NSGENBIND} --trace=${SIZEDIR}/trace.json --mem-stats -I ${SIZEDIR} ${SIZEDIR}/bench.bnd ${SIZEDIR}/out >> ${LOGFILE}
+
+    ${NSGENBIND} --trace=${SIZEDIR}/trace.json --mem-stats -I ${SIZEDIR} ${SIZEDIR}/bench.bnd ${SIZEDIR}/out > ${SIZEDIR}/memstats 2>> ${LOGFILE}
+
+    if [ $? -ne 0 ]; then
+        echo "FAIL"
+        continue
+    fi
+
+    cat ${SIZEDIR}/memstats >> ${LOGFILE}
+    trace_phases ${SIZEDIR}/trace.json ${SIZE} >> ${BENCHOUTDIR}/phases
+
+    # peak resident set size once the output is generated
+    PEAK=$(awk '$1 == "duk_libdom_output" { print $2 }' ${SIZEDIR}/memstats)
+    echo "${PEAK} KiB"
+done
+
+# report each phase across the sizes with the growth of its time
+# relative to the growth of the input, an exponent near one is linear
+# and near two quadratic.
+sort -k1,1 -k2n ${BENCHOUTDIR}/phases | awk '
+    function report() {
+        if (exponent > 1.5) {
+            printf("  %-30s superlinear (size^%.2f)\n", phase, exponent)
+        }
+    }
+    $1 != phase {
+        if (phase != "") report()
+        phase = $1
+        printf("%s\n", phase)
+        prevsize = 0
+        exponent = 0
+    }
+    {
+        printf("  %8d interfaces %10.3f ms\n", $2, $3)
+        # ignore spans too short to measure reliably
+        if ((prevsize > 0) && (prevms >= 1) && ($3 > 0)) {
+            exponent = log($3 / prevms) / log($2 / prevsize)
+        }
+        prevsize = $2
+        prevms = $3
+    }
+    END {
+        if (phase != "") report()
+    }' | tee -a ${LOGFILE}
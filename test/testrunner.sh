@@ -64,3 +64,194 @@ for TEST in ${BINDINGTESTS};do
 
 done
 
+# Error tests
+#
+# Each binding must be rejected with an exit code rather than a crash and
+#  report the error given in the matching .err file.
+
+ERRORDIR=${TESTSRCDIR}/data/errors
+ERRORTESTS=$(ls ${ERRORDIR}/*.bnd)
+
+for TEST in ${ERRORTESTS};do
+
+  outline
+
+  TESTNAME=$(basename ${TEST} .bnd)
+  TESTDIR=${TESTOUTDIR}/errors/${TESTNAME}
+
+  echo -n "   ERROR: ${TESTNAME}......"
+  echo "   ERROR: ${TESTNAME}......" >>${LOGFILE}
+
+  mkdir -p ${TESTDIR}
+  ERRFILE=${TESTDIR}/testerr
+
+  echo ${NSGENBIND} -g -I ${IDLDIR} ${TEST} ${TESTDIR} >>${LOGFILE} 2>&1
+
+  ${NSGENBIND} -g -I ${IDLDIR} ${TEST} ${TESTDIR} >>${LOGFILE} 2>${ERRFILE}
+
+  RESULT=$?
+
+  cat ${ERRFILE} >> ${LOGFILE}
+
+  # exit codes above 128 are signals
+  if [ ${RESULT} -ne 0 ] && [ ${RESULT} -lt 128 ] &&
+     grep -qF -f ${ERRORDIR}/${TESTNAME}.err ${ERRFILE}; then
+    echo "PASS"
+  else
+    echo "FAIL"
+  fi
+
+done
+
+# Equivalence tests
+#
+# The output must not depend upon the number of jobs, the IDL cache or
+#  generating several bindings in one run. Each binding which generates
+#  is regenerated in those ways and compared with a serial run.
+
+EQUIVDIR=${TESTOUTDIR}/equivalence
+CACHEDIR=${EQUIVDIR}/cache
+JOBS=4
+
+rm -rf ${EQUIVDIR}
+mkdir -p ${CACHEDIR}
+
+# generate binding $2 into directory $1 with the remaining options
+generate() {
+  GENDIR=$1
+  BINDING=$2
+  shift 2
+
+  rm -rf ${GENDIR}
+  mkdir -p ${GENDIR}
+
+  echo ${NSGENBIND} -g -I ${IDLDIR} $* ${BINDING} ${GENDIR} >>${LOGFILE}
+  ${NSGENBIND} -g -I ${IDLDIR} $* ${BINDING} ${GENDIR} >>${LOGFILE} 2>&1
+}
+
+# report whether directory $1 holds the same output as directory $2
+compare() {
+  if diff -r $1 $2 >>${LOGFILE} 2>&1; then
+    echo "PASS"
+  else
+    echo "FAIL"
+  fi
+}
+
+# generate binding $1 serially with options $2 and again with options $3
+#  into the same directory so the absolute paths in the output match
+equivalent() {
+  TESTNAME=$(basename $1 .bnd)
+  OUTDIR=${EQUIVDIR}/${TESTNAME}
+
+  outline
+
+  echo -n "   EQUIV: ${TESTNAME} $3......"
+  echo "   EQUIV: ${TESTNAME} $3......" >>${LOGFILE}
+
+  generate ${OUTDIR} $1 -j 1 $2
+  rm -rf ${OUTDIR}.ref
+  mv ${OUTDIR} ${OUTDIR}.ref
+  generate ${OUTDIR} $1 $3
+
+  compare ${OUTDIR}.ref ${OUTDIR}
+}
+
+# only bindings which generate can be compared
+EQUIVTESTS=""
+for TEST in ${BINDINGTESTS};do
+  if generate ${EQUIVDIR}/$(basename ${TEST} .bnd) ${TEST} -j 1; then
+    EQUIVTESTS="${EQUIVTESTS} ${TEST}"
+  fi
+done
+
+for TEST in ${EQUIVTESTS};do
+  equivalent ${TEST} "" "-j ${JOBS}"
+  # the first run fills the cache and the second reads it
+  equivalent ${TEST} "" "-j ${JOBS} -C ${CACHEDIR}"
+  equivalent ${TEST} "" "-j ${JOBS} -C ${CACHEDIR}"
+  equivalent ${TEST} "--prune" "-j ${JOBS} --prune"
+  equivalent ${TEST} "--shards=3" "-j ${JOBS} --shards=3"
+  equivalent ${TEST} "--class-headers" "-j ${JOBS} --class-headers"
+
+  # reproducible output must also not depend upon the output directory
+  TESTNAME=$(basename ${TEST} .bnd)
+  OUTDIR=${EQUIVDIR}/${TESTNAME}
+
+  outline
+
+  echo -n "   EQUIV: ${TESTNAME} -j ${JOBS} --reproducible......"
+  echo "   EQUIV: ${TESTNAME} -j ${JOBS} --reproducible......" >>${LOGFILE}
+
+  generate ${OUTDIR}.ref ${TEST} -j 1 --reproducible
+  generate ${OUTDIR}/moved ${TEST} -j ${JOBS} --reproducible
+
+  compare ${OUTDIR}.ref ${OUTDIR}/moved
+done
+
+# regenerating after changing one class must skip the unchanged outputs
+#  yet leave exactly the output of a clean generation
+outline
+
+echo -n "   EQUIV: browser-duk incremental......"
+echo "   EQUIV: browser-duk incremental......" >>${LOGFILE}
+
+INCDIR=${EQUIVDIR}/incremental
+OUTDIR=${INCDIR}/out
+
+rm -rf ${INCDIR}
+mkdir -p ${INCDIR}/src
+cp ${BINDINGDIR}/browser-duk.bnd ${BINDINGDIR}/HTMLUnknownElement.bnd ${INCDIR}/src
+generate ${OUTDIR} ${INCDIR}/src/browser-duk.bnd -j 1
+
+sed -e 's|dom_node_unref(spare);|dom_node_unref(spare); /* changed */|' \
+    ${BINDINGDIR}/browser-duk.bnd >${INCDIR}/src/browser-duk.bnd
+
+echo ${NSGENBIND} -v -g -I ${IDLDIR} ${INCDIR}/src/browser-duk.bnd ${OUTDIR} >>${LOGFILE}
+${NSGENBIND} -v -g -I ${IDLDIR} ${INCDIR}/src/browser-duk.bnd ${OUTDIR} >${INCDIR}/verbose 2>&1
+cat ${INCDIR}/verbose >>${LOGFILE}
+mv ${OUTDIR} ${OUTDIR}.inc
+
+generate ${OUTDIR} ${INCDIR}/src/browser-duk.bnd -j 1
+
+# the node class must be rewritten and the others skipped
+if ! grep -q "dom_node_unref(spare); /\* changed \*/" ${OUTDIR}.inc/node.c; then
+  echo "FAIL"
+elif grep -q "^0 of [0-9]* outputs unchanged" ${INCDIR}/verbose; then
+  echo "FAIL"
+elif ! grep -q "^[0-9]* of [0-9]* outputs unchanged" ${INCDIR}/verbose; then
+  echo "FAIL"
+else
+  compare ${OUTDIR}.inc ${OUTDIR}
+fi
+
+# every binding generated by one run
+outline
+
+echo -n "   EQUIV: batch -j ${JOBS}......"
+echo "   EQUIV: batch -j ${JOBS}......" >>${LOGFILE}
+
+BATCHARGS=""
+for TEST in ${EQUIVTESTS};do
+  TESTNAME=$(basename ${TEST} .bnd)
+  OUTDIR=${EQUIVDIR}/${TESTNAME}
+
+  generate ${OUTDIR} ${TEST} -j 1
+  rm -rf ${OUTDIR}.ref
+  mv ${OUTDIR} ${OUTDIR}.ref
+  mkdir -p ${OUTDIR}
+  BATCHARGS="${BATCHARGS} ${TEST} ${OUTDIR}"
+done
+
+echo ${NSGENBIND} -g -I ${IDLDIR} -j ${JOBS} ${BATCHARGS} >>${LOGFILE}
+${NSGENBIND} -g -I ${IDLDIR} -j ${JOBS} ${BATCHARGS} >>${LOGFILE} 2>&1
+
+BATCHRES="PASS"
+for TEST in ${EQUIVTESTS};do
+  OUTDIR=${EQUIVDIR}/$(basename ${TEST} .bnd)
+
+  if ! diff -r ${OUTDIR}.ref ${OUTDIR} >>${LOGFILE} 2>&1; then
+    BATCHRES="FAIL"
+  fi
+done
+echo ${BATCHRES}